@@ -274,6 +274,7 @@ pub fn build(b: *std.Build) !void {
         .HAVE_LANGINFO_H = modern_unix,
         .HAVE_NL_LANGINFO_CODESET = modern_unix,
         .HAVE_NL_MSG_CAT_CNTR = t.isGnuLibC(),
+        .HAVE_POSIX_FADVISE = is_linux,
         .HAVE_PWD_FUNCS = modern_unix,
         .HAVE_READLINK = modern_unix,
         .HAVE_STRNLEN = modern_unix,
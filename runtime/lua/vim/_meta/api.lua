@@ -19,6 +19,14 @@ function vim.api.nvim__buf_debug_extmarks(buffer, keys, dot) end
 --- @return table<string,any>
 function vim.api.nvim__buf_stats(buffer) end
 
+--- Gets the latency of requests handled on an RPC channel.
+---
+--- @param chan integer channel id, 0 for the current channel
+--- @return table<string,any> # Map with "queued" (time from receiving a request until its handler
+--- ran) and "exec" (time in the handler). Each is a histogram where item "i" (zero-based) counts
+--- requests that took less than 2^i microseconds, the last one also counts slower requests.
+function vim.api.nvim__chan_latency(chan) end
+
 --- EXPERIMENTAL: this API may change in the future.
 ---
 --- Sets info for the completion item at the given index. If the info text was shown in a window,
@@ -545,6 +553,26 @@ function vim.api.nvim_buf_is_valid(buffer) end
 --- @return integer # Line count, or 0 for unloaded buffer. |api-buffer|
 function vim.api.nvim_buf_line_count(buffer) end
 
+--- Creates or updates the `extmark`s of a namespace in a range of lines, and
+--- removes the other marks in that range.
+---
+--- Unlike `nvim_buf_clear_namespace()` followed by `nvim_buf_set_extmarks()`,
+--- an existing mark at the same position and with the same options as a new
+--- mark is kept, with its id, and only lines where marks were added, changed
+--- or removed are redrawn.  This is meant for highlighters that recompute all
+--- of their marks after every change, e.g. from semantic tokens.
+---
+--- @param buffer integer Buffer id, or 0 for current buffer
+--- @param ns_id integer Namespace id from `nvim_create_namespace()`
+--- @param line_start integer Start of range of lines to replace
+--- @param line_end integer End of range of lines to replace (exclusive), greater than
+--- {line_start}, or -1 to replace to end of buffer.
+--- @param marks any[][] List of `[line, col, opts]` tuples, see
+--- `nvim_buf_set_extmarks()`, with {line} in the range. Marks
+--- with an "id" in `opts` are always updated.
+--- @return integer[] # Ids of the created/updated/kept extmarks, in the order of {marks}.
+function vim.api.nvim_buf_replace_extmarks(buffer, ns_id, line_start, line_end, marks) end
+
 --- Creates or updates an `extmark`.
 ---
 --- By default a new extmark is created when no id is passed in, but it is also
@@ -693,6 +721,34 @@ function vim.api.nvim_buf_line_count(buffer) end
 --- @return integer # Id of the created/updated extmark
 function vim.api.nvim_buf_set_extmark(buffer, ns_id, line, col, opts) end
 
+--- Creates or updates many `extmark`s in one call.
+---
+--- Same as calling `nvim_buf_set_extmark()` for each item, but faster when
+--- placing many marks, e.g. highlights for a whole buffer: the marks are
+--- placed in buffer order, which keeps the lookups in the mark tree local.
+---
+--- All items are checked before any mark is placed. When placing a mark fails,
+--- the marks created by this call are removed again, but the marks updated by
+--- an "id" that come before the failing item in buffer order keep the update.
+---
+--- Example:
+---
+--- ```lua
+--- local ns = vim.api.nvim_create_namespace('my-plugin')
+--- local ids = vim.api.nvim_buf_set_extmarks(0, ns, {
+---   { 0, 0, { end_col = 3, hl_group = 'Keyword' } },
+---   { 1, 4, { virt_text = { { 'hint', 'Comment' } } } },
+--- })
+--- ```
+---
+--- @param buffer integer Buffer id, or 0 for current buffer
+--- @param ns_id integer Namespace id from `nvim_create_namespace()`
+--- @param marks any[][] List of `[line, col, opts]` tuples, with the same meaning as
+--- the arguments of `nvim_buf_set_extmark()`. `opts` can be
+--- omitted. An "id" can only be used once.
+--- @return integer[] # Ids of the created/updated extmarks, in the order of {marks}.
+function vim.api.nvim_buf_set_extmarks(buffer, ns_id, marks) end
+
 --- Sets a buffer-local `mapping` for the given mode.
 ---
 ---
@@ -2172,6 +2228,13 @@ function vim.api.nvim_set_current_win(window) end
 ---   ```
 ---     ["end", tick]
 ---   ```
+--- - cache: (boolean) reuse the ephemeral highlights that `on_line`,
+---   or `on_range` for a whole line, added for a buffer row, as
+---   long as the buffer is not changed. The callback is not called
+---   again for that row. Rows where virtual text was added, or
+---   where the callback returned false or a skip position, are
+---   not cached. Use this when the highlights only depend on the
+---   buffer text, not on the window or cursor.
 function vim.api.nvim_set_decoration_provider(ns_id, opts) end
 
 --- Sets a highlight group.
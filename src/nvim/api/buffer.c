@@ -357,14 +357,12 @@ void nvim_buf_set_lines(uint64_t channel_id, Buffer buffer, Integer start, Integ
   size_t old_len = (size_t)(end - start);
   ptrdiff_t extra = 0;  // lines added to text, can be negative
   char **lines = (new_len != 0) ? arena_alloc(arena, new_len * sizeof(char *), true) : NULL;
+  size_t *lens = (new_len != 0) ? arena_alloc(arena, new_len * sizeof(size_t), true) : NULL;
 
   for (size_t i = 0; i < new_len; i++) {
     const String l = replacement.items[i].data.string;
-
-    // Fill lines[i] with l's contents. Convert NULs to newlines as required by
-    // NL-used-for-NUL.
-    lines[i] = arena_memdupz(arena, l.data, l.size);
-    memchrsub(lines[i], NUL, NL, l.size);
+    lines[i] = string_to_line(l, arena);
+    lens[i] = l.size;
   }
 
   TRY_WRAP(err, {
@@ -412,25 +410,27 @@ void nvim_buf_set_lines(uint64_t channel_id, Buffer buffer, Integer start, Integ
         goto end;
       }
 
-      inserted_bytes += (bcount_t)strlen(lines[i]) + 1;
+      inserted_bytes += (bcount_t)lens[i] + 1;
     }
 
     // Now we may need to insert the remaining new old_len
-    for (size_t i = to_replace; i < new_len; i++) {
-      int64_t lnum = start + (int64_t)i - 1;
-
-      VALIDATE(lnum < MAXLNUM, "%s", "Index out of bounds", {
+    if (to_replace < new_len) {
+      VALIDATE(start + (int64_t)new_len - 2 < MAXLNUM, "%s", "Index out of bounds", {
         goto end;
       });
 
-      if (ml_append_buf(buf, (linenr_T)lnum, lines[i], 0, false) == FAIL) {
+      size_t to_append = new_len - to_replace;
+      size_t appended = ml_append_buf_lines(buf, (linenr_T)(start + (int64_t)to_replace - 1),
+                                            lines + to_replace, lens + to_replace, to_append);
+      for (size_t i = to_replace; i < to_replace + appended; i++) {
+        inserted_bytes += (bcount_t)lens[i] + 1;
+      }
+      extra += (ptrdiff_t)appended;
+
+      if (appended < to_append) {
         api_set_error(err, kErrorTypeException, "Failed to insert line");
         goto end;
       }
-
-      inserted_bytes += (bcount_t)strlen(lines[i]) + 1;
-
-      extra++;
     }
 
     // Adjust marks. Invalidate any which lie in the
@@ -580,11 +580,7 @@ void nvim_buf_set_text(uint64_t channel_id, Buffer buffer, Integer start_row, In
   new_byte += (bcount_t)(first_item.size);
   for (size_t i = 1; i < new_len - 1; i++) {
     const String l = replacement.items[i].data.string;
-
-    // Fill lines[i] with l's contents. Convert NULs to newlines as required by
-    // NL-used-for-NUL.
-    lines[i] = arena_memdupz(arena, l.data, l.size);
-    memchrsub(lines[i], NUL, NL, l.size);
+    lines[i] = string_to_line(l, arena);
     new_byte += (bcount_t)(l.size) + 1;
   }
   if (replacement.size > 1) {
@@ -641,19 +637,20 @@ void nvim_buf_set_text(uint64_t channel_id, Buffer buffer, Integer start_row, In
     }
 
     // Now we may need to insert the remaining new old_len
-    for (size_t i = to_replace; i < new_len; i++) {
-      int64_t lnum = start_row + (int64_t)i - 1;
-
-      VALIDATE((lnum < MAXLNUM), "%s", "Index out of bounds", {
+    if (to_replace < new_len) {
+      VALIDATE((start_row + (int64_t)new_len - 2 < MAXLNUM), "%s", "Index out of bounds", {
         goto end;
       });
 
-      if (ml_append_buf(buf, (linenr_T)lnum, lines[i], 0, false) == FAIL) {
+      size_t to_append = new_len - to_replace;
+      size_t appended = ml_append_buf_lines(buf, (linenr_T)(start_row + (int64_t)to_replace - 1),
+                                            lines + to_replace, NULL, to_append);
+      extra += (ptrdiff_t)appended;
+
+      if (appended < to_append) {
         api_set_error(err, kErrorTypeException, "Failed to insert line");
         goto end;
       }
-
-      extra++;
     }
 
     colnr_T col_extent = (colnr_T)(end_col
@@ -1350,6 +1347,21 @@ static void fix_cursor_cols(win_T *win, linenr_T start_row, colnr_T start_col, l
   invalidate_botline_win(win);
 }
 
+/// Get the text of a line to be put in a buffer from "l".  NULs are converted
+/// to newlines as required by NL-used-for-NUL.  The string itself is used when
+/// it has no NUL, which is the usual case, instead of copying it again: the
+/// line is only read, and copied into the memline.  Like other API strings,
+/// "l" is NUL-terminated after its "size" bytes.
+static char *string_to_line(String l, Arena *arena)
+{
+  if (l.data != NULL && memchr(l.data, NUL, l.size) == NULL) {
+    return l.data;
+  }
+  char *line = arena_memdupz(arena, l.data, l.size);
+  memchrsub(line, NUL, NL, l.size);
+  return line;
+}
+
 /// Initialise a string array either:
 /// - on the Lua stack (as a table) (if lstate is not NULL)
 /// - as an API array object (if lstate is NULL).
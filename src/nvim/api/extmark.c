@@ -1,7 +1,9 @@
 #include <assert.h>
+#include <inttypes.h>
 #include <lauxlib.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "klib/kvec.h"
@@ -32,6 +34,22 @@
 #include "nvim/pos_defs.h"
 #include "nvim/sign.h"
 
+/// Position of an item for nvim_buf_set_extmarks(), for sorting.
+typedef struct {
+  Integer line;
+  Integer col;
+  size_t idx;  ///< index in the "marks" argument
+} ExtmarkPos;
+
+/// Marks of a namespace that nvim_buf_replace_extmarks() may keep.
+typedef struct {
+  ExtmarkInfoArray marks;          ///< sorted by start position
+  bool *used;                      ///< marks that were kept or updated by id
+  Map(uint32_t, uint32_t) index;   ///< id of a mark to its index in "marks" plus one
+  int line_start;                  ///< new marks must start in [line_start, line_end)
+  int line_end;
+} ExtmarkKeep;
+
 #include "api/extmark.c.generated.h"
 
 void api_extmark_free_all_mem(void)
@@ -530,6 +548,23 @@ ArrayOf(DictAs(get_extmark_item)) nvim_buf_get_extmarks(Buffer buffer, Integer n
 Integer nvim_buf_set_extmark(Buffer buffer, Integer ns_id, Integer line, Integer col,
                              Dict(set_extmark) *opts, Error *err)
   FUNC_API_SINCE(7)
+{
+  buf_T *buf = find_buffer_by_handle(buffer, err);
+  if (!buf) {
+    return 0;
+  }
+
+  VALIDATE_INT(ns_initialized((uint32_t)ns_id), "ns_id", ns_id, {
+    return 0;
+  });
+
+  return buf_set_extmark(buf, ns_id, line, col, opts, NULL, err);
+}
+
+/// @param keep  if not NULL, a mark in "keep" equal to the new mark is kept
+///              instead of placing the new mark
+static Integer buf_set_extmark(buf_T *buf, Integer ns_id, Integer line, Integer col,
+                               Dict(set_extmark) *opts, ExtmarkKeep *keep, Error *err)
 {
   DecorHighlightInline hl = DECOR_HIGHLIGHT_INLINE_INIT;
   // TODO(bfredl): in principle signs with max one (1) hl group and max 4 bytes of text.
@@ -541,15 +576,6 @@ Integer nvim_buf_set_extmark(Buffer buffer, Integer ns_id, Integer line, Integer
   bool has_hl = false;
   bool has_hl_multiple = false;
 
-  buf_T *buf = find_buffer_by_handle(buffer, err);
-  if (!buf) {
-    goto error;
-  }
-
-  VALIDATE_INT(ns_initialized((uint32_t)ns_id), "ns_id", ns_id, {
-    goto error;
-  });
-
   uint32_t id = 0;
   if (HAS_KEY(opts, set_extmark, id)) {
     VALIDATE_EXP((opts->id > 0), "id", "positive Integer", NULL, {
@@ -929,10 +955,20 @@ Integer nvim_buf_set_extmark(Buffer buffer, Integer ns_id, Integer line, Integer
       decor_flags |= MT_FLAG_DECOR_HL;
     }
 
+    bool no_undo = !GET_BOOL_OR_TRUE(opts, set_extmark, undo_restore);
+    if (keep != NULL) {
+      uint16_t flags = mt_flags(right_gravity, no_undo, opts->invalidate, decor.ext) | decor_flags;
+      uint32_t kept = extmark_keep_find(keep, id, (int)line, (colnr_T)col, line2, col2, flags,
+                                        opts->end_right_gravity, decor);
+      if (kept) {
+        decor_free(decor);
+        return (Integer)kept;
+      }
+    }
+
     extmark_set(buf, (uint32_t)ns_id, &id, (int)line, (colnr_T)col, line2, col2,
                 decor, decor_flags, right_gravity, opts->end_right_gravity,
-                !GET_BOOL_OR_TRUE(opts, set_extmark, undo_restore),
-                opts->invalidate, err);
+                no_undo, opts->invalidate, err);
     if (ERROR_SET(err)) {
       decor_free(decor);
       return 0;
@@ -951,6 +987,284 @@ error:
   return 0;
 }
 
+/// Creates or updates many |extmark|s in one call.
+///
+/// Same as calling |nvim_buf_set_extmark()| for each item, but faster when
+/// placing many marks, e.g. highlights for a whole buffer: the marks are
+/// placed in buffer order, which keeps the lookups in the mark tree local.
+///
+/// All items are checked before any mark is placed. When placing a mark fails,
+/// the marks created by this call are removed again, but the marks updated by
+/// an "id" that come before the failing item in buffer order keep the update.
+///
+/// Example:
+///
+/// ```lua
+/// local ns = vim.api.nvim_create_namespace('my-plugin')
+/// local ids = vim.api.nvim_buf_set_extmarks(0, ns, {
+///   { 0, 0, { end_col = 3, hl_group = 'Keyword' } },
+///   { 1, 4, { virt_text = { { 'hint', 'Comment' } } } },
+/// })
+/// ```
+///
+/// @param buffer  Buffer id, or 0 for current buffer
+/// @param ns_id  Namespace id from |nvim_create_namespace()|
+/// @param marks  List of `[line, col, opts]` tuples, with the same meaning as
+///               the arguments of |nvim_buf_set_extmark()|. `opts` can be
+///               omitted. An "id" can only be used once.
+/// @param[out] err   Error details, if any
+/// @return Ids of the created/updated extmarks, in the order of {marks}.
+ArrayOf(Integer) nvim_buf_set_extmarks(Buffer buffer, Integer ns_id, ArrayOf(Array) marks,
+                                       Arena *arena, Error *err)
+  FUNC_API_SINCE(14)
+{
+  Array rv = ARRAY_DICT_INIT;
+
+  buf_T *buf = find_buffer_by_handle(buffer, err);
+  if (!buf) {
+    return rv;
+  }
+  VALIDATE_INT(ns_initialized((uint32_t)ns_id), "ns_id", ns_id, {
+    return rv;
+  });
+
+  return buf_set_extmarks(buf, ns_id, marks, NULL, arena, err);
+}
+
+/// Creates or updates the |extmark|s of a namespace in a range of lines, and
+/// removes the other marks in that range.
+///
+/// Unlike |nvim_buf_clear_namespace()| followed by |nvim_buf_set_extmarks()|,
+/// an existing mark at the same position and with the same options as a new
+/// mark is kept, with its id, and only lines where marks were added, changed
+/// or removed are redrawn.  This is meant for highlighters that recompute all
+/// of their marks after every change, e.g. from semantic tokens.
+///
+/// @param buffer  Buffer id, or 0 for current buffer
+/// @param ns_id  Namespace id from |nvim_create_namespace()|
+/// @param line_start  Start of range of lines to replace
+/// @param line_end  End of range of lines to replace (exclusive), greater than
+///                  {line_start}, or -1 to replace to end of buffer.
+/// @param marks  List of `[line, col, opts]` tuples, see
+///               |nvim_buf_set_extmarks()|, with {line} in the range. Marks
+///               with an "id" in `opts` are always updated.
+/// @param[out] err   Error details, if any. Then no marks have been created
+///                   or removed, see |nvim_buf_set_extmarks()|.
+/// @return Ids of the created/updated/kept extmarks, in the order of {marks}.
+ArrayOf(Integer) nvim_buf_replace_extmarks(Buffer buffer, Integer ns_id, Integer line_start,
+                                           Integer line_end, ArrayOf(Array) marks, Arena *arena,
+                                           Error *err)
+  FUNC_API_SINCE(14)
+{
+  Array rv = ARRAY_DICT_INIT;
+
+  buf_T *buf = find_buffer_by_handle(buffer, err);
+  if (!buf) {
+    return rv;
+  }
+  VALIDATE_INT(ns_initialized((uint32_t)ns_id), "ns_id", ns_id, {
+    return rv;
+  });
+  VALIDATE_RANGE((line_start >= 0 && line_start < MAXLNUM), "line_start", {
+    return rv;
+  });
+  VALIDATE_RANGE((line_end >= -1), "line_end", {
+    return rv;
+  });
+  if (line_end == -1 || line_end > MAXLNUM) {
+    line_end = MAXLNUM;
+  }
+  VALIDATE_RANGE((line_end > line_start), "line_end", {
+    return rv;
+  });
+
+  ExtmarkKeep keep = { .index = MAP_INIT, .line_start = (int)line_start,
+                       .line_end = (int)line_end };
+  keep.marks = extmark_get(buf, (uint32_t)ns_id, (int)line_start, 0, (int)line_end - 1, MAXCOL,
+                           INT64_MAX, kExtmarkNone, false);
+  keep.used = xcalloc(kv_size(keep.marks) + 1, sizeof(bool));
+  for (size_t i = 0; i < kv_size(keep.marks); i++) {
+    map_put(uint32_t, uint32_t)(&keep.index, kv_A(keep.marks, i).start.id, (uint32_t)i + 1);
+  }
+
+  rv = buf_set_extmarks(buf, ns_id, marks, &keep, arena, err);
+  if (!ERROR_SET(err)) {
+    for (size_t i = 0; i < kv_size(keep.marks); i++) {
+      if (!keep.used[i]) {
+        extmark_del_id(buf, (uint32_t)ns_id, kv_A(keep.marks, i).start.id);
+      }
+    }
+  }
+
+  map_destroy(uint32_t, &keep.index);
+  xfree(keep.used);
+  kv_destroy(keep.marks);
+  return rv;
+}
+
+static Array buf_set_extmarks(buf_T *buf, Integer ns_id, Array marks, ExtmarkKeep *keep,
+                              Arena *arena, Error *err)
+{
+  Array rv = ARRAY_DICT_INIT;
+  ExtmarkPos *pos = xmalloc(marks.size * sizeof(*pos));
+  Dict(set_extmark) *opts = xcalloc(marks.size, sizeof(*opts));
+  Set(uint32_t) ids = SET_INIT;
+  Set(uint32_t) new_ids = SET_INIT;  // ids in {marks} that do not exist yet
+  size_t placed = 0;
+  // Marks without an "id" and with an id above this one are created by this call.
+  uint32_t last_id = map_get(uint32_t, uint32_t)(buf->b_extmark_ns, (uint32_t)ns_id);
+
+  // Check all the items before placing any mark.
+  for (size_t i = 0; i < marks.size; i++) {
+    VALIDATE_T("marks item", kObjectTypeArray, marks.items[i].type, {
+      goto cleanup;
+    });
+    Array item = marks.items[i].data.array;
+    VALIDATE_EXP((item.size == 2 || item.size == 3), "marks item", "[line, col, opts]", NULL, {
+      goto cleanup;
+    });
+    VALIDATE_T("line", kObjectTypeInteger, item.items[0].type, {
+      goto cleanup;
+    });
+    VALIDATE_T("col", kObjectTypeInteger, item.items[1].type, {
+      goto cleanup;
+    });
+    pos[i] = (ExtmarkPos){ item.items[0].data.integer, item.items[1].data.integer, i };
+    VALIDATE_RANGE((keep == NULL
+                    || (pos[i].line >= keep->line_start && pos[i].line < keep->line_end)),
+                   "line", {
+      goto cleanup;
+    });
+    if (item.size == 3) {
+      Object o = item.items[2];
+      // An empty Lua table is converted to an empty Array.
+      if (!(o.type == kObjectTypeArray && o.data.array.size == 0)) {
+        VALIDATE_T("opts", kObjectTypeDict, o.type, {
+          goto cleanup;
+        });
+        if (!api_dict_to_keydict(&opts[i], DictHash(set_extmark), o.data.dict, err)) {
+          goto cleanup;
+        }
+      }
+    }
+    // Marks are placed in buffer order, the same id twice would not be
+    // updated in the order of {marks}.
+    if (HAS_KEY(&opts[i], set_extmark, id) && opts[i].id > 0) {
+      VALIDATE(set_put(uint32_t, &ids, (uint32_t)opts[i].id), "Duplicate 'id': %" PRId64,
+               opts[i].id, {
+        goto cleanup;
+      });
+      if (!marktree_lookup_ns(buf->b_marktree, (uint32_t)ns_id, (uint32_t)opts[i].id, false,
+                              NULL).id) {
+        set_put(uint32_t, &new_ids, (uint32_t)opts[i].id);
+      }
+    }
+  }
+  qsort(pos, marks.size, sizeof(*pos), extmark_pos_cmp);
+
+  rv = arena_array(arena, marks.size);
+  rv.size = marks.size;
+  for (; placed < marks.size; placed++) {
+    size_t idx = pos[placed].idx;
+    Integer id = buf_set_extmark(buf, ns_id, pos[placed].line, pos[placed].col, &opts[idx],
+                                 keep, err);
+    if (ERROR_SET(err)) {
+      break;
+    }
+    rv.items[idx] = INTEGER_OBJ(id);
+  }
+
+  if (ERROR_SET(err)) {
+    // Remove the marks created before the error, so that only existing marks
+    // given with an "id" may have changed.
+    for (size_t i = 0; i < placed; i++) {
+      Integer id = rv.items[pos[i].idx].data.integer;
+      if (HAS_KEY(&opts[pos[i].idx], set_extmark, id)
+          ? set_has(uint32_t, &new_ids, (uint32_t)id)
+          : id > last_id) {
+        extmark_del_id(buf, (uint32_t)ns_id, (uint32_t)id);
+      }
+    }
+  }
+
+cleanup:
+  set_destroy(uint32_t, &ids);
+  set_destroy(uint32_t, &new_ids);
+  xfree(opts);
+  xfree(pos);
+  if (ERROR_SET(err)) {
+    return (Array)ARRAY_DICT_INIT;
+  }
+  return rv;
+}
+
+/// Find a mark in "keep" equal to a new mark.  When the new mark has an "id",
+/// the existing mark with that id is updated instead, so it must not be
+/// removed.
+///
+/// @return  id of the mark to keep, or zero to place the new mark.
+static uint32_t extmark_keep_find(ExtmarkKeep *keep, uint32_t id, int row, colnr_T col,
+                                  int end_row, colnr_T end_col, uint16_t flags,
+                                  bool end_right_gravity, DecorInline decor)
+{
+  ExtmarkInfoArray *marks = &keep->marks;
+  if (id != 0) {
+    uint32_t idx = map_get(uint32_t, uint32_t)(&keep->index, id);
+    if (idx) {
+      keep->used[idx - 1] = true;
+    }
+    return 0;
+  }
+
+  // Binary search for the first mark at or after (row, col).
+  size_t lo = 0;
+  size_t hi = kv_size(*marks);
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    MTPos p = kv_A(*marks, mid).start.pos;
+    if (p.row < row || (p.row == row && p.col < col)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  const uint16_t mask = MT_FLAG_EXTERNAL_MASK | MT_FLAG_RIGHT_GRAVITY;
+  for (size_t i = lo; i < kv_size(*marks); i++) {
+    MTPair m = kv_A(*marks, i);
+    if (m.start.pos.row != row || m.start.pos.col != col) {
+      break;
+    }
+    if (keep->used[i] || mt_invalid(m.start) || (m.start.flags & mask) != flags
+        || mt_paired(m.start) != (end_row > -1)) {
+      continue;
+    }
+    if (end_row > -1 && (m.end_pos.row != end_row || m.end_pos.col != end_col
+                         || m.end_right_gravity != end_right_gravity)) {
+      continue;
+    }
+    if (decor_equal(mt_decor(m.start), decor)) {
+      keep->used[i] = true;
+      return m.start.id;
+    }
+  }
+  return 0;
+}
+
+static int extmark_pos_cmp(const void *a, const void *b)
+{
+  const ExtmarkPos *pa = a;
+  const ExtmarkPos *pb = b;
+  if (pa->line != pb->line) {
+    return pa->line < pb->line ? -1 : 1;
+  }
+  if (pa->col != pb->col) {
+    return pa->col < pb->col ? -1 : 1;
+  }
+  // qsort() is not stable: keep the order of marks at the same position.
+  return pa->idx < pb->idx ? -1 : 1;
+}
+
 /// Removes an |extmark|.
 ///
 /// @param buffer Buffer id, or 0 for current buffer
@@ -1072,6 +1386,13 @@ void nvim_buf_clear_namespace(Buffer buffer, Integer ns_id, Integer line_start,
 ///               ```
 ///                 ["end", tick]
 ///               ```
+///             - cache: (boolean) reuse the ephemeral highlights that `on_line`,
+///               or `on_range` for a whole line, added for a buffer row, as
+///               long as the buffer is not changed. The callback is not called
+///               again for that row. Rows where virtual text was added, or
+///               where the callback returned false or a skip position, are
+///               not cached. Use this when the highlights only depend on the
+///               buffer text, not on the window or cursor.
 void nvim_set_decoration_provider(Integer ns_id, Dict(set_decoration_provider) *opts, Error *err)
   FUNC_API_SINCE(7) FUNC_API_LUA_ONLY
 {
@@ -1109,6 +1430,10 @@ void nvim_set_decoration_provider(Integer ns_id, Dict(set_decoration_provider) *
     *v = LUA_NOREF;
   }
 
+  if (opts->cache) {
+    decor_provider_enable_cache(p);
+  }
+
   p->state = kDecorProviderActive;
   p->hl_valid++;
   p->hl_cached = false;
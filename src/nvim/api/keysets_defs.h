@@ -21,6 +21,7 @@ typedef struct {
   LuaRefOf(("range" _, Integer winid, Integer bufnr, Integer start_row, Integer start_col,
             Integer end_row, Integer end_col), *Boolean) on_range;
   LuaRefOf(("end" _, Integer tick)) on_end;
+  Boolean cache;
   LuaRefOf(("hl_def" _)) _on_hl_def;
   LuaRefOf(("spell_nav" _)) _on_spell_nav;
   LuaRefOf(("conceal_line" _)) _on_conceal_line;
@@ -77,6 +77,9 @@ static void mpack_str_small(char **buf, const char *str, size_t len)
 static void remote_ui_destroy(RemoteUI *ui)
   FUNC_ATTR_NONNULL_ALL
 {
+  for (size_t i = 0; i < ui->npending_bufs; i++) {
+    wstream_release_wbuffer(ui->pending_bufs[i]);
+  }
   xfree(ui->packer.startptr);
   XFREE_CLEAR(ui->term_name);
   xfree(ui);
@@ -98,6 +101,7 @@ void remote_ui_disconnect(uint64_t channel_id, Error *err, bool send_error_exit)
     push_call(ui, "error_exit", args);
     ui_flush_buf(ui, false);
   }
+  ui_write_bufs(ui);
   pmap_del(uint64_t)(&connected_uis, channel_id, NULL);
   ui_detach_impl(ui, channel_id);
   Channel *chan = find_channel(channel_id);
@@ -925,8 +929,11 @@ static void ui_flush_buf(RemoteUI *ui, bool incomplete_event)
     ui->nevents_pos = NULL;
   }
 
-  WBuffer *buf = wstream_new_buffer(ui->packer.startptr, BUF_POS(ui), 1, free_block);
-  rpc_write_raw(ui->channel_id, buf);
+  ui->pending_bufs[ui->npending_bufs++]
+    = wstream_new_buffer(ui->packer.startptr, BUF_POS(ui), 1, free_block);
+  if (ui->npending_bufs == UI_WRITE_BATCH) {
+    ui_write_bufs(ui);
+  }
 
   ui->packer.startptr = NULL;
   ui->packer.ptr = NULL;
@@ -936,6 +943,17 @@ static void ui_flush_buf(RemoteUI *ui, bool incomplete_event)
   ui->ncells_pending = 0;
 }
 
+/// Write the filled buffers to the client, with a single write request.
+static void ui_write_bufs(RemoteUI *ui)
+{
+  if (ui->npending_bufs == 0) {
+    return;
+  }
+  size_t n = ui->npending_bufs;
+  ui->npending_bufs = 0;
+  rpc_write_raw(ui->channel_id, ui->pending_bufs, n);
+}
+
 /// An intentional flush (vsync) when Nvim is finished redrawing the screen
 ///
 /// Clients can know this happened by a final "flush" event at the end of the
@@ -950,6 +968,7 @@ void remote_ui_flush(RemoteUI *ui)
     ui_flush_buf(ui, false);
     ui->flushed_events = false;
   }
+  ui_write_bufs(ui);
 }
 
 void remote_ui_ui_send(RemoteUI *ui, String content)
@@ -966,6 +985,7 @@ void remote_ui_ui_send(RemoteUI *ui, String content)
 void remote_ui_flush_pending_data(RemoteUI *ui)
 {
   ui_flush_buf(ui, false);
+  ui_write_bufs(ui);
 }
 
 static Array translate_contents(RemoteUI *ui, Array contents, Arena *arena)
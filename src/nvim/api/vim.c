@@ -34,6 +34,8 @@
 #include "nvim/eval/typval.h"
 #include "nvim/eval/typval_defs.h"
 #include "nvim/eval/vars.h"
+#include "nvim/event/loop.h"
+#include "nvim/event/multiqueue.h"
 #include "nvim/ex_docmd.h"
 #include "nvim/ex_eval.h"
 #include "nvim/fold.h"
@@ -51,6 +53,7 @@
 #include "nvim/lua/executor.h"
 #include "nvim/lua/treesitter.h"
 #include "nvim/macros_defs.h"
+#include "nvim/main.h"
 #include "nvim/mapping.h"
 #include "nvim/mark.h"
 #include "nvim/mark_defs.h"
@@ -1803,13 +1806,44 @@ Float nvim__id_float(Float flt)
 /// @return Map of various internal stats.
 Dict nvim__stats(Arena *arena)
 {
-  Dict rv = arena_dict(arena, 6);
+  Dict rv = arena_dict(arena, 15);
   PUT_C(rv, "fsync", INTEGER_OBJ(g_stats.fsync));
   PUT_C(rv, "log_skip", INTEGER_OBJ(g_stats.log_skip));
   PUT_C(rv, "lua_refcount", INTEGER_OBJ(nlua_get_global_ref_count()));
+  PUT_C(rv, "ml_find_line", INTEGER_OBJ(g_stats.ml_find_line));
   PUT_C(rv, "redraw", INTEGER_OBJ(g_stats.redraw));
+  PUT_C(rv, "redraw_lines", INTEGER_OBJ(g_stats.redraw_lines));
+  PUT_C(rv, "redraw_lines_skipped", INTEGER_OBJ(g_stats.redraw_lines_skipped));
+  PUT_C(rv, "regexp_cache_hit", INTEGER_OBJ(g_stats.regexp_cache_hit));
+  PUT_C(rv, "regexp_cache_miss", INTEGER_OBJ(g_stats.regexp_cache_miss));
   PUT_C(rv, "arena_alloc_count", INTEGER_OBJ((Integer)arena_alloc_count));
   PUT_C(rv, "ts_query_parse_count", INTEGER_OBJ((Integer)tslua_query_parse_count));
+  PUT_C(rv, "thread_wakeups", INTEGER_OBJ((Integer)main_loop.thread_wakeups));
+  PUT_C(rv, "thread_events_max", INTEGER_OBJ((Integer)main_loop.thread_events_max));
+  // Longest time an event waited in the queue, in microseconds.
+  uint64_t wait = multiqueue_wait_max(main_loop.events, false) / 1000;
+  PUT_C(rv, "event_wait_max", INTEGER_OBJ((Integer)wait));
+  wait = multiqueue_wait_max(main_loop.events, true) / 1000;
+  PUT_C(rv, "event_bg_wait_max", INTEGER_OBJ((Integer)wait));
+  return rv;
+}
+
+/// Gets the latency of requests handled on an RPC channel.
+///
+/// @param chan  channel id, 0 for the current channel
+/// @return Map with "queued" (time from receiving a request until its
+///         handler ran) and "exec" (time in the handler). Each is a histogram
+///         where item "i" (zero-based) counts requests that took less than 2^i
+///         microseconds, the last one also counts slower requests.
+Dict nvim__chan_latency(uint64_t channel_id, Integer chan, Arena *arena, Error *err)
+{
+  if (chan == 0 && !is_internal_call(channel_id)) {
+    chan = (Integer)channel_id;
+  }
+  Dict rv = ARRAY_DICT_INIT;
+  VALIDATE_INT((chan > 0 && rpc_latency_info((uint64_t)chan, &rv, arena)), "channel", chan, {
+    return (Dict)ARRAY_DICT_INIT;
+  });
   return rv;
 }
 
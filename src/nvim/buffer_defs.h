@@ -1088,6 +1088,18 @@ typedef struct {
   schar_T truncrl;
 } fcs_chars_T;
 
+/// Maximum number of separate line ranges in w_redraw_ranges[].
+enum { REDRAW_RANGES = 8, };
+
+/// Range of buffer lines that needs to be redrawn.
+typedef struct {
+  linenr_T top;  ///< first line
+  linenr_T bot;  ///< last line
+} redraw_range_T;
+
+/// Cached sizes of long lines in a window, see plines.c.
+typedef struct linesize_cache LineSizeCache;
+
 /// Structure which contains all information that belongs to a window.
 ///
 /// All row numbers are relative to the start of the window, except w_winrow.
@@ -1265,6 +1277,8 @@ struct window_S {
   wline_T *w_lines;
   int w_lines_size;
 
+  LineSizeCache *w_linesize_cache;  // sizes of long lines, NULL when unused
+
   garray_T w_folds;                 // array of nested folds
   bool w_fold_manual;               // when true: some folds are opened/closed
                                     // manually
@@ -1283,6 +1297,10 @@ struct window_S {
                                     // w_redr_type is UPD_REDRAW_TOP
   linenr_T w_redraw_top;            // when != 0: first line needing redraw
   linenr_T w_redraw_bot;            // when != 0: last line needing redraw
+  redraw_range_T w_redraw_ranges[REDRAW_RANGES];  // sorted, disjoint ranges
+                                    // between w_redraw_top and w_redraw_bot
+  int w_redraw_nranges;             // number of used w_redraw_ranges[], -1
+                                    // to redraw all lines in between
   bool w_redr_status;               // if true statusline/winbar must be redrawn
   bool w_redr_border;               // if true border must be redrawn
   bool w_redr_statuscol;            // if true 'statuscolumn' must be redrawn
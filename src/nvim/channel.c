@@ -361,6 +361,10 @@ Channel *channel_job_start(char **argv, const char *exepath, CallbackReader on_s
                            varnumber_T *status_out)
 {
   Channel *chan = channel_alloc(kChannelStreamProc);
+  if (!rpc) {
+    // Output and exit callbacks should not delay RPC requests, timers, etc.
+    multiqueue_set_background(chan->events);
+  }
   chan->on_data = on_stdout;
   chan->on_stderr = on_stderr;
   chan->on_exit = on_exit;
@@ -25,6 +25,7 @@
 #include "nvim/memory_defs.h"
 #include "nvim/move.h"
 #include "nvim/option_vars.h"
+#include "nvim/plines.h"
 #include "nvim/pos_defs.h"
 #include "nvim/sign.h"
 
@@ -97,6 +98,9 @@ void decor_redraw(buf_T *buf, int row1, int row2, int col1, DecorInline decor)
       bool below = (vt->flags & kVTIsLines) && !(vt->flags & kVTLinesAbove);
       linenr_T vt_lnum = row1 + 1 + below;
       redraw_buf_line_later(buf, vt_lnum, true);
+      if (!(vt->flags & kVTIsLines) && vt->pos == kVPosInline) {
+        linesize_cache_invalidate();
+      }
       if (vt->flags & kVTIsLines || vt->pos == kVPosInline) {
         // changed_lines_redraw_buf(buf, vt_lnum, vt_lnum + 1, 0);
         colnr_T vt_col = vt->flags & kVTIsLines ? 0 : col1;
@@ -314,6 +318,82 @@ static void decor_free_inner(DecorVirtText *vt, uint32_t first_idx)
   }
 }
 
+static bool virt_text_equal(const VirtText *a, const VirtText *b)
+{
+  if (kv_size(*a) != kv_size(*b)) {
+    return false;
+  }
+  for (size_t i = 0; i < kv_size(*a); i++) {
+    if (kv_A(*a, i).hl_id != kv_A(*b, i).hl_id
+        || !strequal(kv_A(*a, i).text, kv_A(*b, i).text)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool decor_vt_equal(const DecorVirtText *a, const DecorVirtText *b)
+{
+  for (; a && b; a = a->next, b = b->next) {
+    if (a->flags != b->flags || a->hl_mode != b->hl_mode || a->priority != b->priority
+        || a->width != b->width || a->col != b->col || a->pos != b->pos) {
+      return false;
+    }
+    if (a->flags & kVTIsLines) {
+      const VirtLines *la = &a->data.virt_lines;
+      const VirtLines *lb = &b->data.virt_lines;
+      if (kv_size(*la) != kv_size(*lb)) {
+        return false;
+      }
+      for (size_t i = 0; i < kv_size(*la); i++) {
+        if (kv_A(*la, i).flags != kv_A(*lb, i).flags
+            || !virt_text_equal(&kv_A(*la, i).line, &kv_A(*lb, i).line)) {
+          return false;
+        }
+      }
+    } else if (!virt_text_equal(&a->data.virt_text, &b->data.virt_text)) {
+      return false;
+    }
+  }
+  return a == b;
+}
+
+static bool decor_sh_equal(uint32_t a, uint32_t b)
+{
+  while (a != DECOR_ID_INVALID && b != DECOR_ID_INVALID) {
+    DecorSignHighlight *sa = &kv_A(decor_items, a);
+    DecorSignHighlight *sb = &kv_A(decor_items, b);
+    if (sa->flags != sb->flags || sa->priority != sb->priority || sa->hl_id != sb->hl_id
+        || memcmp(sa->text, sb->text, sizeof(sa->text)) != 0
+        || sa->number_hl_id != sb->number_hl_id || sa->line_hl_id != sb->line_hl_id
+        || sa->cursorline_hl_id != sb->cursorline_hl_id
+        || !strequal(sa->sign_name, sb->sign_name)
+        || !strequal(sa->url, sb->url)) {
+      return false;
+    }
+    a = sa->next;
+    b = sb->next;
+  }
+  return a == b;
+}
+
+/// Check if two decorations would be drawn the same.  The placement order of
+/// signs ("sign_add_id") is not compared.
+bool decor_equal(DecorInline a, DecorInline b)
+{
+  if (a.ext != b.ext) {
+    return false;
+  }
+  if (!a.ext) {
+    DecorHighlightInline ha = a.data.hl;
+    DecorHighlightInline hb = b.data.hl;
+    return ha.flags == hb.flags && ha.priority == hb.priority && ha.hl_id == hb.hl_id
+           && ha.conceal_char == hb.conceal_char;
+  }
+  return decor_sh_equal(a.data.ext.sh_idx, b.data.ext.sh_idx)
+         && decor_vt_equal(a.data.ext.vt, b.data.ext.vt);
+}
+
 /// Check if we are in a callback while drawing, which might invalidate the marktree iterator.
 ///
 /// This should be called whenever a structural modification has been done to a
@@ -612,6 +692,9 @@ static void decor_range_insert(DecorState *state, DecorRange *range)
 void decor_range_add_virt(DecorState *state, int start_row, int start_col, int end_row, int end_col,
                           DecorVirtText *vt, bool owned)
 {
+  if (owned && state->running_decor_provider) {
+    decor_provider_record(start_row, start_col, end_row, end_col, NULL, 0, 0, 0);
+  }
   bool is_lines = vt->flags & kVTIsLines;
   DecorRange range = {
     .start_row = start_row, .start_col = start_col, .end_row = end_row, .end_col = end_col,
@@ -632,6 +715,9 @@ void decor_range_add_sh(DecorState *state, int start_row, int start_col, int end
   if (sh->flags & kSHIsSign) {
     return;
   }
+  if (owned && state->running_decor_provider) {
+    decor_provider_record(start_row, start_col, end_row, end_col, sh, ns, mark_id, subpriority);
+  }
 
   DecorRange range = {
     .start_row = start_row, .start_col = start_col, .end_row = end_row, .end_col = end_col,
@@ -136,6 +136,8 @@ typedef struct {
 // initializes in a valid state for the DecorHighlightInline branch
 #define DECOR_INLINE_INIT { .ext = false, .data.hl = DECOR_HIGHLIGHT_INLINE_INIT }
 
+typedef struct DecorProviderCache DecorProviderCache;
+
 typedef struct {
   NS ns_id;
 
@@ -162,9 +164,13 @@ typedef struct {
   bool hl_cached;
 
   uint8_t error_count;
+
+  /// Ephemeral highlights of on_line and on_range per buffer row, NULL when
+  /// the provider was not set with "cache".
+  DecorProviderCache *cache;
 } DecorProvider;
 
 #define DECORATION_PROVIDER_INIT(ns_id) (DecorProvider) \
   { ns_id, kDecorProviderDisabled, 0, 0, LUA_NOREF, LUA_NOREF, \
     LUA_NOREF, LUA_NOREF, LUA_NOREF, LUA_NOREF, \
-    LUA_NOREF, LUA_NOREF, -1, false, false, 0 }
+    LUA_NOREF, LUA_NOREF, -1, false, false, 0, NULL }
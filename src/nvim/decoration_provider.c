@@ -7,22 +7,59 @@
 #include "nvim/api/extmark.h"
 #include "nvim/api/private/defs.h"
 #include "nvim/api/private/helpers.h"
+#include "nvim/buffer.h"
 #include "nvim/buffer_defs.h"
 #include "nvim/decoration.h"
 #include "nvim/decoration_defs.h"
 #include "nvim/decoration_provider.h"
+#include "nvim/eval/typval_defs.h"
 #include "nvim/globals.h"
 #include "nvim/highlight.h"
 #include "nvim/log.h"
 #include "nvim/lua/executor.h"
+#include "nvim/map_defs.h"
+#include "nvim/memory.h"
 #include "nvim/message.h"
 #include "nvim/move.h"
 #include "nvim/pos_defs.h"
 
+/// An ephemeral highlight cached for a provider with "cache".
+typedef struct {
+  int start_row;
+  int start_col;
+  int end_row;
+  int end_col;
+  DecorSignHighlight sh;  ///< "url" is owned by the cache
+  uint32_t ns_id;
+  uint32_t mark_id;
+  DecorPriority subpriority;
+} DecorCacheItem;
+
+typedef kvec_t(DecorCacheItem) DecorCacheRow;
+
+/// Cached rows of one buffer, only valid for one changedtick.
+typedef struct {
+  varnumber_T changedtick;
+  size_t n_items;
+  PMap(int) rows;  ///< row * 2, plus one for on_range -> DecorCacheRow *
+} DecorCacheBuf;
+
+struct DecorProviderCache {
+  PMap(int) bufs;  ///< buffer handle -> DecorCacheBuf *
+};
+
+/// Drop the cache of a buffer when it grows beyond this many items.
+enum { DECOR_CACHE_MAX_ITEMS = 100000, };
+
 #include "decoration_provider.c.generated.h"
 
 static kvec_t(DecorProvider) decor_providers = KV_INITIAL_VALUE;
 
+/// Row being recorded while a callback of a provider with "cache" runs.
+static DecorCacheRow *cache_rec = NULL;
+/// Set when the callback added something that cannot be cached.
+static bool cache_rec_failed = false;
+
 static void decor_provider_error(DecorProvider *provider, const char *name, const char *msg)
 {
   const char *ns = describe_ns(provider->ns_id, "(UNKNOWN PLUGIN)");
@@ -113,6 +150,9 @@ void decor_providers_start(void)
 {
   for (size_t i = 0; i < kv_size(decor_providers); i++) {
     DecorProvider *p = &kv_A(decor_providers, i);
+    if (p->cache != NULL) {
+      decor_cache_purge(p->cache);
+    }
     if (p->state != kDecorProviderDisabled && p->redraw_start != LUA_NOREF) {
       MAXSIZE_TEMP_ARRAY(args, 2);
       ADD_C(args, INTEGER_OBJ((int)display_tick));
@@ -167,6 +207,139 @@ void decor_providers_invoke_win(win_T *wp)
   }
 }
 
+static void decor_cache_row_free(DecorCacheRow *row)
+{
+  for (size_t i = 0; i < kv_size(*row); i++) {
+    xfree((void *)kv_A(*row, i).sh.url);
+  }
+  kv_destroy(*row);
+}
+
+static void decor_cache_buf_clear(DecorCacheBuf *cb)
+{
+  DecorCacheRow *row;
+  map_foreach_value(&cb->rows, row, {
+    decor_cache_row_free(row);
+    xfree(row);
+  })
+  map_destroy(int, &cb->rows);
+  cb->n_items = 0;
+}
+
+static void decor_cache_free(DecorProviderCache *cache)
+{
+  if (cache == NULL) {
+    return;
+  }
+  DecorCacheBuf *cb;
+  map_foreach_value(&cache->bufs, cb, {
+    decor_cache_buf_clear(cb);
+    xfree(cb);
+  })
+  map_destroy(int, &cache->bufs);
+  xfree(cache);
+}
+
+/// Drop the cached rows of buffers that were wiped out.
+static void decor_cache_purge(DecorProviderCache *cache)
+{
+  kvec_t(int) dead = KV_INITIAL_VALUE;
+  int handle;
+  map_foreach_key(&cache->bufs, handle, {
+    if (handle_get_buffer(handle) == NULL) {
+      kv_push(dead, handle);
+    }
+  })
+  for (size_t i = 0; i < kv_size(dead); i++) {
+    DecorCacheBuf *cb = pmap_del(int)(&cache->bufs, kv_A(dead, i), NULL);
+    decor_cache_buf_clear(cb);
+    xfree(cb);
+  }
+  kv_destroy(dead);
+}
+
+/// @return  the cache of "buf", emptied if the buffer changed since it was filled
+static DecorCacheBuf *decor_cache_get(DecorProviderCache *cache, buf_T *buf)
+{
+  ptr_t *ref = pmap_put_ref(int)(&cache->bufs, buf->handle, NULL, NULL);
+  if (*ref == NULL) {
+    *ref = xcalloc(1, sizeof(DecorCacheBuf));
+  }
+  DecorCacheBuf *cb = *ref;
+  varnumber_T tick = buf_get_changedtick(buf);
+  if (cb->changedtick != tick || cb->n_items > DECOR_CACHE_MAX_ITEMS) {
+    decor_cache_buf_clear(cb);
+    cb->changedtick = tick;
+  }
+  return cb;
+}
+
+/// Record an ephemeral decoration added by a callback of a provider with
+/// "cache".  Virtual text is not cached: "sh" is NULL for it and the row is
+/// not stored.
+void decor_provider_record(int start_row, int start_col, int end_row, int end_col,
+                           const DecorSignHighlight *sh, uint32_t ns_id, uint32_t mark_id,
+                           DecorPriority subpriority)
+{
+  if (cache_rec == NULL) {
+    return;
+  }
+  if (sh == NULL) {
+    cache_rec_failed = true;
+    return;
+  }
+  DecorCacheItem item = {
+    .start_row = start_row, .start_col = start_col, .end_row = end_row, .end_col = end_col,
+    .sh = *sh, .ns_id = ns_id, .mark_id = mark_id, .subpriority = subpriority,
+  };
+  item.sh.url = sh->url ? xstrdup(sh->url) : NULL;
+  kv_push(*cache_rec, item);
+}
+
+/// Invoke the 'line' or 'range' callback of a provider with "cache" for a
+/// whole buffer row, or add the ephemeral highlights it added for the same
+/// row the last time, if the buffer did not change since.
+static bool decor_provider_invoke_cached(int provider_idx, buf_T *buf, int key, const char *name,
+                                         LuaRef ref, Array args, Array *res)
+{
+  DecorProvider *p = &kv_A(decor_providers, provider_idx);
+  DecorCacheRow *row = pmap_get(int)(&decor_cache_get(p->cache, buf)->rows, key);
+  if (row != NULL) {
+    for (size_t i = 0; i < kv_size(*row); i++) {
+      DecorCacheItem *item = &kv_A(*row, i);
+      DecorSignHighlight sh = item->sh;
+      sh.url = sh.url ? xstrdup(sh.url) : NULL;
+      decor_range_add_sh(&decor_state, item->start_row, item->start_col, item->end_row,
+                         item->end_col, &sh, true, item->ns_id, item->mark_id,
+                         item->subpriority);
+    }
+    return true;
+  }
+
+  DecorCacheRow rec = KV_INITIAL_VALUE;
+  cache_rec = &rec;
+  cache_rec_failed = false;
+  bool status = decor_provider_invoke(provider_idx, name, ref, args, true, res);
+  cache_rec = NULL;
+
+  p = &kv_A(decor_providers, provider_idx);  // lua call might have reallocated decor_providers
+  // Returning false or a skip position affects the rows after this one, which
+  // would not happen when the row is taken from the cache.
+  bool skip = res && res->size >= 1 && !(res->items[0].type == kObjectTypeNil
+                                         || (res->items[0].type == kObjectTypeBoolean
+                                             && res->items[0].data.boolean));
+  if (status && !skip && !cache_rec_failed && p->cache != NULL) {
+    DecorCacheBuf *cb = decor_cache_get(p->cache, buf);
+    row = xmalloc(sizeof(*row));
+    *row = rec;
+    pmap_put(int)(&cb->rows, key, row);
+    cb->n_items += kv_size(rec) + 1;
+  } else {
+    decor_cache_row_free(&rec);
+  }
+  return status;
+}
+
 /// For each provider invoke the 'line' callback for a given window row.
 ///
 /// @param      wp        Window
@@ -184,7 +357,11 @@ void decor_providers_invoke_line(win_T *wp, int row)
       ADD_C(args, WINDOW_OBJ(wp->handle));
       ADD_C(args, BUFFER_OBJ(wp->w_buffer->handle));
       ADD_C(args, INTEGER_OBJ(row));
-      if (!decor_provider_invoke((int)i, "line", p->redraw_line, args, true, NULL)) {
+      bool status = p->cache
+                    ? decor_provider_invoke_cached((int)i, wp->w_buffer, row * 2, "line",
+                                                   p->redraw_line, args, NULL)
+                    : decor_provider_invoke((int)i, "line", p->redraw_line, args, true, NULL);
+      if (!status) {
         // return 'false' or error: skip rest of this window
         kv_A(decor_providers, i).state = kDecorProviderWinDisabled;
       }
@@ -213,7 +390,13 @@ void decor_providers_invoke_range(win_T *wp, int start_row, int start_col, int e
       ADD_C(args, INTEGER_OBJ(end_row));
       ADD_C(args, INTEGER_OBJ(end_col));
       Array res = ARRAY_DICT_INIT;
-      bool status = decor_provider_invoke((int)i, "range", p->redraw_range, args, true, &res);
+      bool status;
+      if (p->cache && start_col == 0 && end_row == start_row + 1 && end_col == 0) {
+        status = decor_provider_invoke_cached((int)i, wp->w_buffer, start_row * 2 + 1, "range",
+                                              p->redraw_range, args, &res);
+      } else {
+        status = decor_provider_invoke((int)i, "range", p->redraw_range, args, true, &res);
+      }
       p = &kv_A(decor_providers, i);  // lua call might have reallocated decor_providers
 
       if (!status) {
@@ -334,9 +517,18 @@ void decor_provider_clear(DecorProvider *p)
   NLUA_CLEAR_REF(p->redraw_end);
   NLUA_CLEAR_REF(p->spell_nav);
   NLUA_CLEAR_REF(p->conceal_line);
+  decor_cache_free(p->cache);
+  p->cache = NULL;
   p->state = kDecorProviderDisabled;
 }
 
+void decor_provider_enable_cache(DecorProvider *p)
+{
+  if (p->cache == NULL) {
+    p->cache = xcalloc(1, sizeof(*p->cache));
+  }
+}
+
 void decor_free_all_mem(void)
 {
   for (size_t i = 0; i < kv_size(decor_providers); i++) {
@@ -1495,6 +1495,16 @@ int win_line(win_T *wp, linenr_T lnum, int startrow, int endrow, int col_rows, b
     int vcol = wlv.vcol;
     StrCharInfo ci = utf_ptr2StrCharInfo(ptr);
     while (vcol < start_vcol) {
+      // Printable ASCII takes one cell per character.  Leave the last one
+      // before "start_vcol" for win_charsize(), it sets "cs".
+      if (cstype == kCharsizeFast && !wp->w_p_list && start_vcol - vcol > 1) {
+        size_t avail = strnlen(ci.ptr, (size_t)(start_vcol - vcol - 1));
+        size_t run = utf_ascii_run_len(ci.ptr, avail);
+        if (run > 0) {
+          ci = utf_ptr2StrCharInfo(ci.ptr + run);
+          vcol += (int)run;
+        }
+      }
       cs = win_charsize(cstype, vcol, ci.ptr, ci.chr.value, &csarg);
       vcol += cs.width;
       prev_ptr = ci.ptr;
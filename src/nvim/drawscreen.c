@@ -653,6 +653,15 @@ int update_screen(void)
       wp->w_redr_type = UPD_NOT_VALID;
     }
 
+    // A hidden float is not composed.  Buffer changes are only tracked until
+    // b_mod_set is reset below, so redraw it fully once it is shown again.
+    if (wp->w_floating && wp->w_config.hide && wp != curwin) {
+      if (wp->w_redr_type != 0 || wp->w_buffer->b_mod_set) {
+        wp->w_redr_type = MAX(wp->w_redr_type, UPD_NOT_VALID);
+      }
+      continue;
+    }
+
     win_check_ns_hl(wp);
 
     // reallocate grid if needed.
@@ -1408,6 +1417,11 @@ static void win_update(win_T *wp)
   linenr_T syntax_last_parsed = 0;              // last parsed text line
   linenr_T mod_top = 0;
   linenr_T mod_bot = 0;
+  // Sorted ranges of lines between mod_top and mod_bot that need to be
+  // redrawn, valid lines in between them are skipped.  Not used when
+  // "ndamage" is zero.
+  redraw_range_T damage[REDRAW_RANGES];
+  int ndamage = 0;
 
   int type = wp->w_redr_type;
 
@@ -1504,7 +1518,23 @@ static void win_update(win_T *wp)
     } else {
       mod_bot = 0;
     }
+    // Only lines in separate ranges were changed, e.g. by decorations.
+    // Folds and concealed lines can make more lines change, redraw the
+    // whole area then.
+    if (wp->w_redraw_nranges > 0 && !win_lines_concealed(wp)) {
+      ndamage = wp->w_redraw_nranges;
+      memcpy(damage, wp->w_redraw_ranges, (size_t)ndamage * sizeof(*damage));
+    }
     if (buf->b_mod_set) {
+      if (buf->b_mod_xlines != 0) {
+        ndamage = 0;
+      } else if (ndamage > 0) {
+        linenr_T t = buf->b_mod_top;
+        if (syntax_present(wp)) {
+          t = MAX(t - buf->b_s.b_syn_sync_linebreaks, 1);
+        }
+        ndamage = redraw_range_add(damage, ndamage, t, buf->b_mod_bot - 1);
+      }
       if (mod_top == 0 || mod_top > buf->b_mod_top) {
         mod_top = buf->b_mod_top;
         // Need to redraw lines above the change that may be included
@@ -1548,6 +1578,10 @@ static void win_update(win_T *wp)
       if (mod_bot == 0 || mod_bot < search_hl_has_cursor_lnum + 1) {
         mod_bot = search_hl_has_cursor_lnum + 1;
       }
+      if (ndamage > 0) {
+        ndamage = redraw_range_add(damage, ndamage, search_hl_has_cursor_lnum,
+                                   search_hl_has_cursor_lnum);
+      }
     }
 
     if (mod_top != 0 && win_lines_concealed(wp)) {
@@ -1604,6 +1638,7 @@ static void win_update(win_T *wp)
 
   wp->w_redraw_top = 0;  // reset for next time
   wp->w_redraw_bot = 0;
+  wp->w_redraw_nranges = 0;
   search_hl_has_cursor_lnum = 0;
 
   // When only displaying the lines at the top, set top_end.  Used when
@@ -2010,6 +2045,11 @@ static void win_update(win_T *wp)
     // with.  It is used further down when the line doesn't fit.
     srow = row;
 
+    // A valid line in between the ranges that need to be redrawn.
+    bool in_gap = ndamage > 0 && idx < wp->w_lines_valid && wp->w_lines[idx].wl_valid
+                  && wp->w_lines[idx].wl_lnum == lnum
+                  && redraw_range_gap(damage, ndamage, lnum, wp->w_lines[idx].wl_lastlnum);
+
     // Update a line when it is in an area that needs updating, when it
     // has changes or w_lines[idx] is invalid.
     // "bot_start" may be halfway a wrapped line after using
@@ -2025,7 +2065,7 @@ static void win_update(win_T *wp)
         || (mod_top != 0
             && (lnum == mod_top
                 || (lnum >= mod_top
-                    && (lnum < mod_bot
+                    && ((lnum < mod_bot && !in_gap)
                         || did_update == DID_FOLD
                         || (did_update == DID_LINE
                             && syntax_present(wp)
@@ -2131,6 +2171,10 @@ static void win_update(win_T *wp)
             }
           }
           int xtra_rows = new_rows - old_rows;
+          if (xtra_rows != 0 || i != j) {
+            // Lines in between the changed ranges move, redraw them too.
+            ndamage = 0;
+          }
           if (xtra_rows < 0) {
             // May scroll text up.  If there is not enough
             // remaining text or scrolling fails, must redraw the
@@ -2205,6 +2249,9 @@ static void win_update(win_T *wp)
         }
       }
 
+      int old_size = idx < wp->w_lines_valid && wp->w_lines[idx].wl_valid
+                     && wp->w_lines[idx].wl_lnum == lnum ? wp->w_lines[idx].wl_size : -1;
+
       if (foldinfo.fi_lines == 0
           && idx < wp->w_lines_valid
           && wp->w_lines[idx].wl_valid
@@ -2230,6 +2277,7 @@ static void win_update(win_T *wp)
         spellvars_T zero_spv = { 0 };
         row = win_line(wp, lnum, srow, wp->w_view_height, 0, concealed,
                        display_buf_line ? &spv : &zero_spv, foldinfo);
+        g_stats.redraw_lines++;
 
         if (display_buf_line) {
           syntax_last_parsed = lnum;
@@ -2271,6 +2319,9 @@ static void win_update(win_T *wp)
       if (dollar_vcol == -1 || !is_curline) {
         wp->w_lines[idx].wl_size = (uint16_t)(row - srow);
       }
+      if (wp->w_lines[idx].wl_size != old_size) {
+        ndamage = 0;  // the lines below moved
+      }
       lnum = wp->w_lines[idx++].wl_lastlnum + 1;
     } else {
       // If:
@@ -2286,6 +2337,7 @@ static void win_update(win_T *wp)
       }
 
       // This line does not need to be drawn, advance to the next one.
+      g_stats.redraw_lines_skipped++;
       row += wp->w_lines[idx++].wl_size;
       if (row > wp->w_view_height) {  // past end of screen
         break;
@@ -2673,6 +2725,7 @@ void redraw_buf_line_later(buf_T *buf, linenr_T line, bool force)
       redrawWinline(wp, MIN(line, buf->b_ml.ml_line_count));
       if (force && line > buf->b_ml.ml_line_count) {
         wp->w_redraw_bot = line;
+        wp->w_redraw_nranges = -1;
       }
     }
   }
@@ -2681,6 +2734,13 @@ void redraw_buf_line_later(buf_T *buf, linenr_T line, bool force)
 void redraw_win_range_later(win_T *wp, linenr_T first, linenr_T last)
 {
   if (last >= wp->w_topline && first < wp->w_botline) {
+    if (wp->w_redraw_top == 0) {
+      wp->w_redraw_nranges = 0;
+    }
+    if (wp->w_redraw_nranges >= 0) {
+      wp->w_redraw_nranges = redraw_range_add(wp->w_redraw_ranges, wp->w_redraw_nranges,
+                                              first, last);
+    }
     if (wp->w_redraw_top == 0 || wp->w_redraw_top > first) {
       wp->w_redraw_top = first;
     }
@@ -2691,6 +2751,61 @@ void redraw_win_range_later(win_T *wp, linenr_T first, linenr_T last)
   }
 }
 
+/// Add lines "first" to "last" to the "n" sorted, disjoint ranges in "r".
+/// Ranges that overlap or touch are merged.  When there are more than
+/// REDRAW_RANGES ranges the two with the smallest gap between them are
+/// merged, so that the result still covers all lines.
+///
+/// @return  the new number of ranges
+static int redraw_range_add(redraw_range_T *r, int n, linenr_T first, linenr_T last)
+{
+  redraw_range_T tmp[REDRAW_RANGES + 1];
+  int i = 0;
+  int m = 0;
+
+  while (i < n && r[i].bot + 1 < first) {
+    tmp[m++] = r[i++];
+  }
+  while (i < n && r[i].top <= last + 1) {
+    first = MIN(first, r[i].top);
+    last = MAX(last, r[i].bot);
+    i++;
+  }
+  tmp[m++] = (redraw_range_T){ .top = first, .bot = last };
+  while (i < n) {
+    tmp[m++] = r[i++];
+  }
+
+  if (m > REDRAW_RANGES) {
+    int k = 0;
+    for (i = 1; i + 1 < m; i++) {
+      if (tmp[i + 1].top - tmp[i].bot < tmp[k + 1].top - tmp[k].bot) {
+        k = i;
+      }
+    }
+    tmp[k].bot = tmp[k + 1].bot;
+    m--;
+    memmove(&tmp[k + 1], &tmp[k + 2], (size_t)(m - k - 1) * sizeof(*tmp));
+  }
+  memcpy(r, tmp, (size_t)m * sizeof(*tmp));
+  return m;
+}
+
+/// Check if lines "first" to "last" are in between the "n" ranges in "r",
+/// thus do not need to be redrawn.  Always false when "n" is zero.
+static bool redraw_range_gap(const redraw_range_T *r, int n, linenr_T first, linenr_T last)
+{
+  if (n == 0) {
+    return false;
+  }
+  for (int i = 0; i < n && r[i].top <= last; i++) {
+    if (r[i].bot >= first) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /// Changed something in the current window, at buffer line "lnum", that
 /// requires that line and possibly other lines to be redrawn.
 /// Used when entering/leaving Insert mode with the cursor on a folded line.
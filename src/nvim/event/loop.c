@@ -6,6 +6,7 @@
 #include "nvim/event/loop.h"
 #include "nvim/event/multiqueue.h"
 #include "nvim/log.h"
+#include "nvim/macros_defs.h"
 #include "nvim/memory.h"
 #include "nvim/os/time.h"
 #include "nvim/types_defs.h"
@@ -22,6 +23,9 @@ void loop_init(Loop *loop, void *data)
   loop->events = multiqueue_new(loop_on_put, loop);
   loop->fast_events = multiqueue_new_child(loop->events);
   loop->thread_events = multiqueue_new(NULL, NULL);
+  loop->thread_batch = multiqueue_new(NULL, NULL);
+  loop->thread_wakeups = 0;
+  loop->thread_events_max = 0;
   uv_mutex_init(&loop->mutex);
   uv_async_init(&loop->uv, &loop->async, async_cb);
   uv_signal_init(&loop->uv, &loop->children_watcher);
@@ -93,9 +97,14 @@ bool loop_poll_events(Loop *loop, int64_t ms)
 void loop_schedule_fast(Loop *loop, Event event)
 {
   uv_mutex_lock(&loop->mutex);
+  // Only the first event of a batch needs to wake up the loop: async_cb()
+  // takes all events that were queued until it runs.
+  bool wakeup = multiqueue_empty(loop->thread_events);
   multiqueue_put_event(loop->thread_events, event);
-  uv_async_send(&loop->async);
   uv_mutex_unlock(&loop->mutex);
+  if (wakeup) {
+    uv_async_send(&loop->async);
+  }
 }
 
 /// Schedules an event from another thread. Unlike loop_schedule_fast(), the
@@ -188,6 +197,7 @@ bool loop_close(Loop *loop, bool wait)
   }
   multiqueue_free(loop->fast_events);
   multiqueue_free(loop->thread_events);
+  multiqueue_free(loop->thread_batch);
   multiqueue_free(loop->events);
   kv_destroy(loop->children);
   return rv;
@@ -212,10 +222,18 @@ size_t loop_size(Loop *loop)
 static void async_cb(uv_async_t *handle)
 {
   Loop *l = handle->loop->data;
+  // Take the queued events with the mutex held only for swapping the queues.
+  MultiQueue *batch = l->thread_batch;
   uv_mutex_lock(&l->mutex);
-  // Flush thread_events to fast_events for processing on main loop.
-  multiqueue_move_events(l->fast_events, l->thread_events);
+  l->thread_batch = l->thread_events;
+  l->thread_events = batch;
   uv_mutex_unlock(&l->mutex);
+
+  // Flush the batch to fast_events for processing on main loop.
+  batch = l->thread_batch;
+  l->thread_wakeups++;
+  l->thread_events_max = MAX(l->thread_events_max, multiqueue_size(batch));
+  multiqueue_move_events(l->fast_events, batch);
 }
 
 static void timer_cb(uv_timer_t *handle)
@@ -10,7 +10,11 @@
 struct loop {
   uv_loop_t uv;
   MultiQueue *events;
+  // Events scheduled from other threads, protected by `mutex`.
   MultiQueue *thread_events;
+  // Empty queue that is swapped with `thread_events` by the main thread, so that
+  // other threads only wait for the swap, not for the events to be moved.
+  MultiQueue *thread_batch;
   // Immediate events.
   // - "Processed after exiting `uv_run()` (to avoid recursion), but before returning from
   //   `loop_poll_events()`." 502aee690c98
@@ -35,6 +39,9 @@ struct loop {
   uv_mutex_t mutex;
   int recursive;
   bool closing;  ///< Set to true if loop_close() has been called
+
+  size_t thread_wakeups;     ///< Number of times `async` woke up the loop
+  size_t thread_events_max;  ///< Largest batch of `thread_events` moved at once
 };
 
 #include "event/loop.h.generated.h"
@@ -41,15 +41,25 @@
 // the event loop queue and poll job1 queue instead. Same with channels, when
 // calling `rpcrequest` we want to temporarily stop processing events from
 // other sources and focus on a specific channel.
+//
+// A child queue can be marked as "background" (e.g. the output callbacks of a
+// job), then its link nodes are kept in a separate lane of the parent queue.
+// Removing from the parent takes the oldest node of the normal lane, except that
+// every MQ_BACKGROUND_RATIO-th node is taken from the background lane, so that
+// a chatty job delays other events less but is not starved by them either. The
+// order of the events of one child queue is kept.
 
 #include <assert.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "nvim/event/defs.h"
 #include "nvim/event/multiqueue.h"
 #include "nvim/lib/queue_defs.h"
+#include "nvim/macros_defs.h"
 #include "nvim/memory.h"
+#include "nvim/os/time.h"
 
 typedef struct multiqueue_item MultiQueueItem;
 struct multiqueue_item {
@@ -61,15 +71,26 @@ struct multiqueue_item {
     } item;
   } data;
   bool link;  // true: current item is just a link to a node in a child queue
+  uint64_t queued;  // time it was put on a root queue, for the wait stats
   QUEUE node;
 };
 
 struct multiqueue {
   MultiQueue *parent;
   QUEUE headtail;  // circularly-linked
+  QUEUE background;  // link nodes of background child queues (root queue only)
   PutCallback on_put;  // Called on the parent (if any) when an item is enqueued in a child.
   void *data;
   size_t size;
+  bool is_background;  // child queue: link nodes go to the "background" lane
+  int normal_count;  // normal items removed while "background" was not empty
+  uint64_t wait_max[2];  // longest time a normal/background item waited (ns)
+};
+
+enum {
+  /// One in this many events removed from a root queue is taken from the
+  /// background lane, when both lanes have events.
+  MQ_BACKGROUND_RATIO = 4,
 };
 
 typedef struct {
@@ -101,18 +122,29 @@ static MultiQueue *_multiqueue_new(MultiQueue *parent, PutCallback on_put, void
 {
   MultiQueue *rv = xmalloc(sizeof(MultiQueue));
   QUEUE_INIT(&rv->headtail);
+  QUEUE_INIT(&rv->background);
   rv->size = 0;
   rv->parent = parent;
   rv->on_put = on_put;
   rv->data = data;
+  rv->is_background = false;
+  rv->normal_count = 0;
+  rv->wait_max[0] = rv->wait_max[1] = 0;
   return rv;
 }
 
 void multiqueue_free(MultiQueue *self)
 {
   assert(self);
+  multiqueue_free_items(self, &self->headtail);
+  multiqueue_free_items(self, &self->background);
+  xfree(self);
+}
+
+static void multiqueue_free_items(MultiQueue *self, QUEUE *lane)
+{
   QUEUE *q;
-  QUEUE_FOREACH(q, &self->headtail, {
+  QUEUE_FOREACH(q, lane, {
     MultiQueueItem *item = multiqueue_node_data(q);
     if (self->parent) {
       QUEUE_REMOVE(&item->data.item.parent_item->node);
@@ -121,8 +153,24 @@ void multiqueue_free(MultiQueue *self)
     QUEUE_REMOVE(q);
     xfree(item);
   })
+}
 
-  xfree(self);
+/// Puts the events of child queue `self` in the background lane of its parent:
+/// they are processed after the events of other queues, but not starved by them.
+void multiqueue_set_background(MultiQueue *self)
+  FUNC_ATTR_NONNULL_ALL
+{
+  assert(self->parent && multiqueue_empty(self));
+  self->is_background = true;
+}
+
+/// Gets the longest time an event waited in root queue `self`, in nanoseconds.
+///
+/// @param background  the background lane instead of the normal one
+uint64_t multiqueue_wait_max(MultiQueue *self, bool background)
+  FUNC_ATTR_NONNULL_ALL
+{
+  return self->wait_max[background];
 }
 
 /// Removes the next item and returns its Event.
@@ -173,7 +221,7 @@ void multiqueue_purge_events(MultiQueue *self)
 bool multiqueue_empty(MultiQueue *self)
 {
   assert(self);
-  return QUEUE_EMPTY(&self->headtail);
+  return QUEUE_EMPTY(&self->headtail) && QUEUE_EMPTY(&self->background);
 }
 
 void multiqueue_replace_parent(MultiQueue *self, MultiQueue *new_parent)
@@ -222,10 +270,23 @@ static Event multiqueueitem_get_event(MultiQueueItem *item, bool remove)
 static Event multiqueue_remove(MultiQueue *self)
 {
   assert(!multiqueue_empty(self));
-  QUEUE *h = QUEUE_HEAD(&self->headtail);
+  bool background = false;
+  if (!QUEUE_EMPTY(&self->background)) {
+    if (QUEUE_EMPTY(&self->headtail) || self->normal_count >= MQ_BACKGROUND_RATIO - 1) {
+      background = true;
+      self->normal_count = 0;
+    } else {
+      self->normal_count++;
+    }
+  }
+  QUEUE *h = QUEUE_HEAD(background ? &self->background : &self->headtail);
   QUEUE_REMOVE(h);
   MultiQueueItem *item = multiqueue_node_data(h);
   assert(!item->link || !self->parent);  // Only a parent queue has link-nodes
+  if (!self->parent) {
+    uint64_t wait = os_hrtime() - item->queued;
+    self->wait_max[background] = MAX(self->wait_max[background], wait);
+  }
   Event ev = multiqueueitem_get_event(item, true);
   self->size--;
   xfree(item);
@@ -238,13 +299,15 @@ static void multiqueue_push(MultiQueue *self, Event event)
   item->link = false;
   item->data.item.event = event;
   item->data.item.parent_item = NULL;
+  item->queued = self->parent ? 0 : os_hrtime();
   QUEUE_INSERT_TAIL(&self->headtail, &item->node);
   if (self->parent) {
     // push link node to the parent queue
     item->data.item.parent_item = xmalloc(sizeof(MultiQueueItem));
     item->data.item.parent_item->link = true;
+    item->data.item.parent_item->queued = os_hrtime();
     item->data.item.parent_item->data.queue = self;
-    QUEUE_INSERT_TAIL(&self->parent->headtail,
+    QUEUE_INSERT_TAIL(self->is_background ? &self->parent->background : &self->parent->headtail,
                       &item->data.item.parent_item->node);
   }
   self->size++;
@@ -1,6 +1,7 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
 #include <uv.h>
 
 #include "nvim/event/defs.h"
@@ -14,8 +15,9 @@
 
 typedef struct {
   Stream *stream;
-  WBuffer *buffer;
   uv_write_t uv_req;
+  size_t nbufs;
+  WBuffer *buffers[];
 } WRequest;
 
 #include "event/wstream.c.generated.h"
@@ -66,31 +68,53 @@ void wstream_set_write_cb(Stream *stream, stream_write_cb cb, void *data)
 /// @return 0 on success, or libuv error code on failure
 int wstream_write(Stream *stream, WBuffer *buffer)
   FUNC_ATTR_NONNULL_ALL
+{
+  return wstream_writev(stream, &buffer, 1);
+}
+
+/// Like wstream_write(), but queues several buffers with a single write
+/// request, which writes them with one writev() call when possible.
+///
+/// @param stream The `Stream` instance
+/// @param buffers The buffers to be written, in order
+/// @param nbufs Number of buffers, at least one
+/// @return 0 on success, or libuv error code on failure. The buffers are
+///         released on failure.
+int wstream_writev(Stream *stream, WBuffer **buffers, size_t nbufs)
+  FUNC_ATTR_NONNULL_ALL
 {
   assert(stream->maxmem);
   assert(!stream->use_poll);
   // This should not be called after a stream was freed
   assert(!stream->closed);
+  assert(nbufs > 0);
 
   int err = 0;
-  uv_buf_t uvbuf;
-  uvbuf.base = buffer->data;
-  uvbuf.len = UV_BUF_LEN(buffer->size);
+  uv_buf_t stackbufs[8];
+  uv_buf_t *uvbufs = nbufs <= ARRAY_SIZE(stackbufs) ? stackbufs : xmalloc(nbufs * sizeof(*uvbufs));
+  size_t size = 0;
+  for (size_t i = 0; i < nbufs; i++) {
+    uvbufs[i].base = buffers[i]->data;
+    uvbufs[i].len = UV_BUF_LEN(buffers[i]->size);
+    size += buffers[i]->size;
+  }
 
   if (!stream->uvstream) {
     uv_fs_t req;
 
     // Synchronous write
-    err = uv_fs_write(stream->uv.idle.loop, &req, stream->fd, &uvbuf, 1, stream->fpos, NULL);
+    err = uv_fs_write(stream->uv.idle.loop, &req, stream->fd, uvbufs, (unsigned)nbufs,
+                      stream->fpos, NULL);
 
     uv_fs_req_cleanup(&req);
 
-    wstream_release_wbuffer(buffer);
+    release_wbuffers(buffers, nbufs);
 
     assert(stream->write_cb == NULL);
 
     stream->fpos += MAX(req.result, 0);
-    return req.result > 0 ? 0 : err != 0 ? err : UV_UNKNOWN;
+    err = req.result > 0 ? 0 : err != 0 ? err : UV_UNKNOWN;
+    goto end;
   }
 
   if (stream->curmem > stream->maxmem) {
@@ -98,25 +122,30 @@ int wstream_write(Stream *stream, WBuffer *buffer)
     goto fail;
   }
 
-  stream->curmem += buffer->size;
-
-  WRequest *data = xmalloc(sizeof(WRequest));
+  WRequest *data = xmalloc(sizeof(WRequest) + nbufs * sizeof(WBuffer *));
   data->stream = stream;
-  data->buffer = buffer;
+  data->nbufs = nbufs;
+  memcpy(data->buffers, buffers, nbufs * sizeof(WBuffer *));
   data->uv_req.data = data;
 
-  if ((err = uv_write(&data->uv_req, stream->uvstream, &uvbuf, 1, write_cb)) != 0) {
+  // libuv copies the uv_buf_t array, "uvbufs" can be freed when it returns.
+  if ((err = uv_write(&data->uv_req, stream->uvstream, uvbufs, (unsigned)nbufs, write_cb)) != 0) {
     xfree(data);
     goto fail;
   }
 
+  stream->curmem += size;
   stream->pending_reqs++;
   assert(err == 0);
-  return 0;
+  goto end;
 
 fail:
-  wstream_release_wbuffer(buffer);
+  release_wbuffers(buffers, nbufs);
   assert(err != 0);
+end:
+  if (uvbufs != stackbufs) {
+    xfree(uvbufs);
+  }
   return err;
 }
 
@@ -148,9 +177,11 @@ static void write_cb(uv_write_t *req, int status)
 {
   WRequest *data = req->data;
 
-  data->stream->curmem -= data->buffer->size;
+  for (size_t i = 0; i < data->nbufs; i++) {
+    data->stream->curmem -= data->buffers[i]->size;
+  }
 
-  wstream_release_wbuffer(data->buffer);
+  release_wbuffers(data->buffers, data->nbufs);
 
   if (data->stream->write_cb) {
     data->stream->write_cb(data->stream, data->stream->cb_data, status);
@@ -166,6 +197,13 @@ static void write_cb(uv_write_t *req, int status)
   xfree(data);
 }
 
+static void release_wbuffers(WBuffer **buffers, size_t nbufs)
+{
+  for (size_t i = 0; i < nbufs; i++) {
+    wstream_release_wbuffer(buffers[i]);
+  }
+}
+
 void wstream_release_wbuffer(WBuffer *buffer)
   FUNC_ATTR_NONNULL_ALL
 {
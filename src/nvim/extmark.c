@@ -27,6 +27,7 @@
 
 #include <assert.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "nvim/api/private/defs.h"
 #include "nvim/buffer_defs.h"
@@ -47,6 +48,11 @@
 
 #include "extmark.c.generated.h"
 
+/// extmark_clear() looks up the marks of a namespace by id when it has fewer
+/// than 1/EXTMARK_CLEAR_BY_ID_RATIO of the marks in the buffer.  A lookup by
+/// id costs about as much as that many steps over the tree.
+enum { EXTMARK_CLEAR_BY_ID_RATIO = 8, };
+
 /// Create or update an extmark
 ///
 /// must not be used during iteration!
@@ -217,23 +223,42 @@ bool extmark_clear(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_col, int u_r
   bool marks_cleared_all = l_row == 0 && l_col == 0;
 
   MarkTreeIter itr[1] = { 0 };
-  marktree_itr_get(buf->b_marktree, l_row, l_col, itr);
-  while (true) {
-    MTKey mark = marktree_itr_current(itr);
-    if (mark.pos.row < 0
-        || mark.pos.row > u_row
-        || (mark.pos.row == u_row && mark.pos.col > u_col)) {
-      if (mark.pos.row >= 0) {
-        marks_cleared_all = false;
+  size_t ns_count = all_ns ? 0 : marktree_ns_count(buf->b_marktree, ns_id);
+  if (!all_ns && ns_count * EXTMARK_CLEAR_BY_ID_RATIO < buf->b_marktree->n_keys) {
+    // Most marks belong to other namespaces: look up the marks of this
+    // namespace by id instead of walking over all marks in the range.
+    marks_cleared_any = extmark_clear_by_id(buf, ns_id, ns_count, l_row, l_col, u_row, u_col);
+    marktree_itr_get(buf->b_marktree, u_row, u_col, itr);
+    while (true) {
+      MTKey mark = marktree_itr_current(itr);
+      if (mark.pos.row < 0 || mark.pos.row > u_row
+          || (mark.pos.row == u_row && mark.pos.col > u_col)) {
+        if (mark.pos.row >= 0) {
+          marks_cleared_all = false;
+        }
+        break;
       }
-      break;
-    }
-    if (mark.ns == ns_id || all_ns) {
-      marks_cleared_any = true;
-      extmark_del(buf, itr, mark, true);
-    } else {
       marktree_itr_next(buf->b_marktree, itr);
     }
+  } else {
+    marktree_itr_get(buf->b_marktree, l_row, l_col, itr);
+    while (true) {
+      MTKey mark = marktree_itr_current(itr);
+      if (mark.pos.row < 0
+          || mark.pos.row > u_row
+          || (mark.pos.row == u_row && mark.pos.col > u_col)) {
+        if (mark.pos.row >= 0) {
+          marks_cleared_all = false;
+        }
+        break;
+      }
+      if (mark.ns == ns_id || all_ns) {
+        marks_cleared_any = true;
+        extmark_del(buf, itr, mark, true);
+      } else {
+        marktree_itr_next(buf->b_marktree, itr);
+      }
+    }
   }
 
   if (marks_cleared_all) {
@@ -252,6 +277,46 @@ bool extmark_clear(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_col, int u_r
   return marks_cleared_any;
 }
 
+static bool extmark_pos_in_range(MTPos pos, int l_row, colnr_T l_col, int u_row, colnr_T u_col)
+{
+  return (pos.row > l_row || (pos.row == l_row && pos.col >= l_col))
+         && (pos.row < u_row || (pos.row == u_row && pos.col <= u_col));
+}
+
+/// Delete the marks of "ns_id" that start or end in a range, found by id.
+///
+/// @return  true if any mark was deleted
+static bool extmark_clear_by_id(buf_T *buf, uint32_t ns_id, size_t ns_count, int l_row,
+                                colnr_T l_col, int u_row, colnr_T u_col)
+{
+  // Deleting marks changes the set, copy the ids first.
+  uint32_t *ids = xmalloc(ns_count * sizeof(*ids));
+  size_t n = 0;
+  uint32_t id;
+  set_foreach(marktree_ns_ids(buf->b_marktree, ns_id), id, {
+    ids[n++] = id;
+  });
+  assert(n == ns_count);
+
+  bool deleted = false;
+  for (size_t i = 0; i < n; i++) {
+    MarkTreeIter itr[1] = { 0 };
+    MTKey mark = marktree_lookup_ns(buf->b_marktree, ns_id, ids[i], false, itr);
+    if (mark.pos.row < 0) {
+      continue;
+    }
+    if (extmark_pos_in_range(mark.pos, l_row, l_col, u_row, u_col)
+        || (mt_paired(mark)
+            && extmark_pos_in_range(marktree_get_alt(buf->b_marktree, mark, NULL).pos,
+                                    l_row, l_col, u_row, u_col))) {
+      extmark_del(buf, itr, mark, false);
+      deleted = true;
+    }
+  }
+  xfree(ids);
+  return deleted;
+}
+
 /// @return  the position of marks between a range,
 ///          marks found at the start or end index will be included.
 ///
@@ -264,6 +329,12 @@ ExtmarkInfoArray extmark_get(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_co
   ExtmarkInfoArray array = KV_INITIAL_VALUE;
   MarkTreeIter itr[1];
 
+  // Stop when all marks of the namespace have been seen.
+  size_t ns_left = ns_id == UINT32_MAX ? SIZE_MAX : marktree_ns_count(buf->b_marktree, ns_id);
+  if (ns_left == 0) {
+    return array;
+  }
+
   if (overlap) {
     // Find all the marks overlapping the start position
     if (!marktree_itr_get_overlap(buf->b_marktree, l_row, l_col, itr)) {
@@ -283,7 +354,7 @@ ExtmarkInfoArray extmark_get(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_co
                          itr, false, false, NULL, NULL);
   }
 
-  while ((int64_t)kv_size(array) < amount) {
+  while ((int64_t)kv_size(array) < amount && ns_left > 0) {
     MTKey mark = marktree_itr_current(itr);
     if (mark.pos.row < 0
         || (mark.pos.row > u_row)
@@ -291,6 +362,9 @@ ExtmarkInfoArray extmark_get(buf_T *buf, uint32_t ns_id, int l_row, colnr_T l_co
       break;
     }
     if (!mt_end(mark)) {
+      if (mark.ns == ns_id) {
+        ns_left--;
+      }
       MTKey end = marktree_get_alt(buf->b_marktree, mark, NULL);
       push_mark(&array, ns_id, type_filter, mtpair_from(mark, end));
     }
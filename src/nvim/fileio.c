@@ -876,6 +876,10 @@ retry:
     if (read_undo_file) {
       sha256_start(&sha_ctx);
     }
+    // The whole file is read front to back: let the OS read ahead.
+    if (!read_stdin && !read_buffer && !read_fifo && perm >= 0 && S_ISREG(perm)) {
+      os_fadvise_sequential(fd);
+    }
   }
 
   while (!error && !got_int) {
@@ -1515,59 +1519,69 @@ rewind_retry:
         }
       }
     } else {
-      ptr--;
-      while (++ptr, --size >= 0) {
-        if ((c = *ptr) != NUL && c != NL) {        // catch most common case
-          continue;
+      // Find the line ends with memchr(), which libc implements with wide
+      // loads.  NULs are rare, only look for them when the block has any.
+      char *const end = ptr + size;
+      const bool has_nul = memchr(ptr, NUL, (size_t)size) != NULL;
+      while (ptr < end) {
+        char *const nl = memchr(ptr, NL, (size_t)(end - ptr));
+        char *const eol = nl != NULL ? nl : end;
+        if (has_nul) {
+          char *nul;
+          while ((nul = memchr(ptr, NUL, (size_t)(eol - ptr))) != NULL) {
+            *nul = NL;          // NULs are replaced by newlines!
+            ptr = nul + 1;
+          }
         }
-        if (c == NUL) {
-          *ptr = NL;            // NULs are replaced by newlines!
-        } else {
-          if (skip_count == 0) {
-            *ptr = NUL;                         // end of line
-            len = (colnr_T)(ptr - line_start + 1);
-            if (fileformat == EOL_DOS) {
-              if (ptr > line_start && ptr[-1] == CAR) {
-                // remove CR before NL
-                ptr[-1] = NUL;
-                len--;
-              } else if (ff_error != EOL_DOS) {
-                // Reading in Dos format, but no CR-LF found!
-                // When 'fileformats' includes "unix", delete all
-                // the lines read so far and start all over again.
-                // Otherwise give an error message later.
-                if (try_unix
-                    && !read_stdin
-                    && (read_buffer || vim_lseek(fd, 0, SEEK_SET) == 0)) {
-                  fileformat = EOL_UNIX;
-                  if (set_options) {
-                    set_fileformat(EOL_UNIX, OPT_LOCAL);
-                  }
-                  file_rewind = true;
-                  keep_fileformat = true;
-                  goto retry;
+        ptr = eol;
+        if (nl == NULL) {
+          break;
+        }
+        if (skip_count == 0) {
+          *ptr = NUL;                         // end of line
+          len = (colnr_T)(ptr - line_start + 1);
+          if (fileformat == EOL_DOS) {
+            if (ptr > line_start && ptr[-1] == CAR) {
+              // remove CR before NL
+              ptr[-1] = NUL;
+              len--;
+            } else if (ff_error != EOL_DOS) {
+              // Reading in Dos format, but no CR-LF found!
+              // When 'fileformats' includes "unix", delete all
+              // the lines read so far and start all over again.
+              // Otherwise give an error message later.
+              if (try_unix
+                  && !read_stdin
+                  && (read_buffer || vim_lseek(fd, 0, SEEK_SET) == 0)) {
+                fileformat = EOL_UNIX;
+                if (set_options) {
+                  set_fileformat(EOL_UNIX, OPT_LOCAL);
                 }
-                ff_error = EOL_DOS;
+                file_rewind = true;
+                keep_fileformat = true;
+                goto retry;
               }
+              ff_error = EOL_DOS;
             }
-            if (ml_append(lnum, line_start, len, newfile) == FAIL) {
-              error = true;
-              break;
-            }
-            if (read_undo_file) {
-              sha256_update(&sha_ctx, (uint8_t *)line_start, (size_t)len);
-            }
-            lnum++;
-            if (--read_count == 0) {
-              error = true;                         // break loop
-              line_start = ptr;                 // nothing left to write
-              break;
-            }
-          } else {
-            skip_count--;
           }
-          line_start = ptr + 1;
+          if (ml_append(lnum, line_start, len, newfile) == FAIL) {
+            error = true;
+            break;
+          }
+          if (read_undo_file) {
+            sha256_update(&sha_ctx, (uint8_t *)line_start, (size_t)len);
+          }
+          lnum++;
+          if (--read_count == 0) {
+            error = true;                         // break loop
+            line_start = ptr;                 // nothing left to write
+            break;
+          }
+        } else {
+          skip_count--;
         }
+        line_start = ptr + 1;
+        ptr++;
       }
     }
     linerest = (ptr - line_start);
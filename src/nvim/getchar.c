@@ -1520,10 +1520,14 @@ static void updatescript(int c)
   }
   bool idle = (c == 0);
   if (idle || (p_uc > 0 && ++count >= p_uc)) {
-    ml_sync_all(idle, true,
-                (!!p_fs || idle));  // Always fsync at idle (CursorHold).
+    // Always fsync at idle (CursorHold), in the background to avoid a hitch
+    // on slow filesystems.
+    ml_sync_all(idle, true, (!!p_fs || idle), idle);
     count = 0;
   }
+  if (idle) {
+    ml_compress_all();
+  }
 }
 
 /// Merge "modifiers" into "c_arg".
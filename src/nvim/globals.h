@@ -85,7 +85,12 @@ EXTERN struct nvim_stats_s {
   int64_t fsync;
   int64_t redraw;
   int16_t log_skip;  // How many logs were tried and skipped before log_init.
-} g_stats INIT( = { 0, 0, 0 });
+  int64_t ml_find_line;  // Lookups of a memline data block from the tree.
+  int64_t regexp_cache_hit;  // vim_regcomp() reused a compiled pattern.
+  int64_t regexp_cache_miss;  // vim_regcomp() had to compile a pattern.
+  int64_t redraw_lines;  // Buffer lines drawn by win_update().
+  int64_t redraw_lines_skipped;  // Valid lines win_update() did not draw.
+} g_stats INIT( = { 0, 0, 0, 0, 0, 0, 0, 0 });
 
 // Values for "starting".
 #define NO_SCREEN       2       // no screen updating yet
@@ -439,24 +439,42 @@ void grid_line_put_schar(int col, schar_T schar, int attr)
 int grid_line_puts(int col, const char *text, int textlen, int attr)
 {
   const char *ptr = text;
-  int len = textlen;
+  const int max_col = grid_line_maxcol;
+  // A cell takes at most MAX_SCHAR_SIZE bytes: don't look for the NUL of a
+  // long text beyond the last column.
+  int len = textlen >= 0 ? textlen
+                         : (int)strnlen(text, (size_t)MAX(max_col - col, 0) * MAX_SCHAR_SIZE);
 
   assert(grid_line_grid);
 
   int start_col = col;
 
-  const int max_col = grid_line_maxcol;
-  while (col < max_col && (len < 0 || (int)(ptr - text) < len) && *ptr != NUL) {
+  // When overwriting the right half of a two-cell character in the same
+  // grid, truncate that into a '>'.
+  if (col < max_col && len > 0 && *text != NUL
+      && col > grid_line_first && col < grid_line_last && linebuf_char[col] == 0) {
+    linebuf_char[col - 1] = schar_from_ascii('>');
+  }
+
+  while (col < max_col && (int)(ptr - text) < len && *ptr != NUL) {
+    // Printable ASCII is copied without decoding it.
+    size_t run = utf_ascii_run_len(ptr, (size_t)(len - (ptr - text)));
+    run = MIN(run, (size_t)(max_col - col));
+    for (size_t i = 0; i < run; i++, col++) {
+      linebuf_char[col] = schar_from_ascii((uint8_t)ptr[i]);
+      linebuf_attr[col] = attr;
+      linebuf_vcol[col] = -1;
+    }
+    ptr += run;
+    if (col >= max_col || (int)(ptr - text) >= len || *ptr == NUL) {
+      break;
+    }
+
     // check if this is the first byte of a multibyte
-    int mbyte_blen;
-    if (len >= 0) {
-      int maxlen = (int)((text + len) - ptr);
-      mbyte_blen = utfc_ptr2len_len(ptr, maxlen);
-      if (mbyte_blen > maxlen) {
-        mbyte_blen = 1;
-      }
-    } else {
-      mbyte_blen = utfc_ptr2len(ptr);
+    int maxlen = (int)((text + len) - ptr);
+    int mbyte_blen = utfc_ptr2len_len(ptr, maxlen);
+    if (mbyte_blen > maxlen) {
+      mbyte_blen = 1;
     }
     int firstc;
     schar_T schar = utfc_ptrlen2schar(ptr, mbyte_blen, &firstc);
@@ -473,13 +491,6 @@ int grid_line_puts(int col, const char *text, int textlen, int attr)
       mbyte_cells = 1;
     }
 
-    // When at the start of the text and overwriting the right half of a
-    // two-cell character in the same grid, truncate that into a '>'.
-    if (ptr == text && col > grid_line_first && col < grid_line_last
-        && linebuf_char[col] == 0) {
-      linebuf_char[col - 1] = schar_from_ascii('>');
-    }
-
     linebuf_char[col] = schar;
     linebuf_attr[col] = attr;
     linebuf_vcol[col] = -1;
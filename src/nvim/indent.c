@@ -829,6 +829,7 @@ bool briopt_check(char *briopt, win_T *wp)
   wp->w_briopt_sbr = bri_sbr;
   wp->w_briopt_list = bri_list;
   wp->w_briopt_vcol = bri_vcol;
+  linesize_cache_invalidate();
 
   return true;
 }
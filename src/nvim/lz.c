@@ -0,0 +1,227 @@
+// lz.c: fast LZ77 compression of in-memory data
+//
+// The format is the LZ4 block format: a sequence of
+//
+//   token  [literal length bytes]  literals  offset  [match length bytes]
+//
+// where the high nibble of "token" is the number of literals and the low
+// nibble the match length minus LZ_MINMATCH.  A nibble of 15 is followed by
+// bytes that are added to it, until a byte that is not 255.  "offset" is a
+// 16 bit little endian distance back from the current output position.  The
+// last sequence only has literals.
+//
+// It is used for data that never leaves the process, e.g. the memfile blocks
+// of buffers without a swapfile, so the format does not need to be stable.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "nvim/lz.h"
+
+#include "lz.c.generated.h"
+
+enum {
+  LZ_MINMATCH = 4,
+  LZ_MAXOFFSET = 0xffff,
+  LZ_HASHLOG = 12,
+  /// Last bytes that are always literals, so that matching can read four
+  /// bytes at a time without checking the end of the input.
+  LZ_LASTLITERALS = 5,
+};
+
+static inline uint32_t lz_read32(const uint8_t *p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint32_t lz_hash(uint32_t v)
+{
+  return (v * 2654435761U) >> (32 - LZ_HASHLOG);
+}
+
+/// Write a length that did not fit in a nibble.
+///
+/// @return  pointer after the written bytes, NULL if "end" was reached
+static uint8_t *lz_put_length(uint8_t *op, const uint8_t *end, size_t len)
+{
+  for (; len >= 255; len -= 255) {
+    if (op >= end) {
+      return NULL;
+    }
+    *op++ = 255;
+  }
+  if (op >= end) {
+    return NULL;
+  }
+  *op++ = (uint8_t)len;
+  return op;
+}
+
+/// Write a sequence of literals from "anchor" to "ip", followed by a match of
+/// "matchlen" bytes at "offset", if "matchlen" is not zero.
+///
+/// @return  pointer after the sequence, NULL if "end" was reached
+static uint8_t *lz_put_sequence(uint8_t *op, const uint8_t *end, const uint8_t *anchor,
+                                const uint8_t *ip, size_t offset, size_t matchlen)
+{
+  size_t litlen = (size_t)(ip - anchor);
+  size_t mlen = matchlen > 0 ? matchlen - LZ_MINMATCH : 0;
+  if (op >= end) {
+    return NULL;
+  }
+  uint8_t *token = op++;
+  *token = (uint8_t)((litlen >= 15 ? 15 : litlen) << 4);
+  if (litlen >= 15 && (op = lz_put_length(op, end, litlen - 15)) == NULL) {
+    return NULL;
+  }
+  if ((size_t)(end - op) < litlen) {
+    return NULL;
+  }
+  memcpy(op, anchor, litlen);
+  op += litlen;
+  if (matchlen == 0) {
+    return op;
+  }
+  if (end - op < 2) {
+    return NULL;
+  }
+  *op++ = (uint8_t)(offset & 0xff);
+  *op++ = (uint8_t)(offset >> 8);
+  *token |= (uint8_t)(mlen >= 15 ? 15 : mlen);
+  if (mlen >= 15 && (op = lz_put_length(op, end, mlen - 15)) == NULL) {
+    return NULL;
+  }
+  return op;
+}
+
+/// Compress "src_len" bytes at "src" into "dst".
+///
+/// @return  size of the compressed data, or zero when it would not fit in
+///          "dst_size" bytes (the data does not compress well).
+size_t lz_compress(const char *src, size_t src_len, char *dst, size_t dst_size)
+  FUNC_ATTR_NONNULL_ALL
+{
+  uint32_t table[1 << LZ_HASHLOG] = { 0 };
+  const uint8_t *const base = (const uint8_t *)src;
+  const uint8_t *const iend = base + src_len;
+  const uint8_t *ip = base;
+  const uint8_t *anchor = base;
+  uint8_t *op = (uint8_t *)dst;
+  const uint8_t *const oend = op + dst_size;
+
+  if (src_len > LZ_MINMATCH + LZ_LASTLITERALS) {
+    const uint8_t *const mflimit = iend - LZ_LASTLITERALS - LZ_MINMATCH;
+    // Position zero is never a candidate, "table" is zero-initialized.
+    ip++;
+    while (ip <= mflimit) {
+      uint32_t seq = lz_read32(ip);
+      uint32_t h = lz_hash(seq);
+      const uint8_t *ref = base + table[h];
+      table[h] = (uint32_t)(ip - base);
+      if (ref == base || ip - ref > LZ_MAXOFFSET || lz_read32(ref) != seq) {
+        ip++;
+        continue;
+      }
+
+      // Extend the match forward, but keep the last literals.
+      const uint8_t *mstart = ip;
+      const uint8_t *mend = ip + LZ_MINMATCH;
+      const uint8_t *rp = ref + LZ_MINMATCH;
+      const uint8_t *const matchlimit = iend - LZ_LASTLITERALS;
+      while (mend < matchlimit && *mend == *rp) {
+        mend++;
+        rp++;
+      }
+      // And backward, over literals not written yet.
+      while (mstart > anchor && ref > base && mstart[-1] == ref[-1]) {
+        mstart--;
+        ref--;
+      }
+
+      op = lz_put_sequence(op, oend, anchor, mstart, (size_t)(mstart - ref),
+                           (size_t)(mend - mstart));
+      if (op == NULL) {
+        return 0;
+      }
+      ip = anchor = mend;
+    }
+  }
+
+  op = lz_put_sequence(op, oend, anchor, iend, 0, 0);
+  if (op == NULL) {
+    return 0;
+  }
+  return (size_t)(op - (uint8_t *)dst);
+}
+
+/// Read a length that did not fit in a nibble and add it to "*len".
+///
+/// @return  pointer after the length, NULL for corrupted input
+static const uint8_t *lz_get_length(const uint8_t *ip, const uint8_t *end, size_t *len)
+{
+  uint8_t b;
+  do {
+    if (ip >= end) {
+      return NULL;
+    }
+    b = *ip++;
+    *len += b;
+  } while (b == 255);
+  return ip;
+}
+
+/// Decompress "src_len" bytes at "src", produced by lz_compress(), into
+/// exactly "dst_len" bytes at "dst".
+///
+/// @return  false if the data is corrupted or has a different size.
+bool lz_decompress(const char *src, size_t src_len, char *dst, size_t dst_len)
+  FUNC_ATTR_NONNULL_ALL
+{
+  const uint8_t *ip = (const uint8_t *)src;
+  const uint8_t *const iend = ip + src_len;
+  uint8_t *const obase = (uint8_t *)dst;
+  uint8_t *op = obase;
+  const uint8_t *const oend = op + dst_len;
+
+  while (ip < iend) {
+    uint8_t token = *ip++;
+    size_t litlen = token >> 4;
+    if (litlen == 15 && (ip = lz_get_length(ip, iend, &litlen)) == NULL) {
+      return false;
+    }
+    if ((size_t)(iend - ip) < litlen || (size_t)(oend - op) < litlen) {
+      return false;
+    }
+    memcpy(op, ip, litlen);
+    op += litlen;
+    ip += litlen;
+    if (ip == iend) {
+      break;  // last sequence
+    }
+
+    if (iend - ip < 2) {
+      return false;
+    }
+    size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+    ip += 2;
+    size_t matchlen = token & 15;
+    if (matchlen == 15 && (ip = lz_get_length(ip, iend, &matchlen)) == NULL) {
+      return false;
+    }
+    matchlen += LZ_MINMATCH;
+    if (offset == 0 || offset > (size_t)(op - obase) || (size_t)(oend - op) < matchlen) {
+      return false;
+    }
+    // Byte by byte: the match may overlap the bytes being written.
+    const uint8_t *rp = op - offset;
+    for (size_t i = 0; i < matchlen; i++) {
+      op[i] = rp[i];
+    }
+    op += matchlen;
+  }
+  return op == oend;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdbool.h>  // IWYU pragma: keep
+#include <stddef.h>  // IWYU pragma: keep
+
+#include "lz.h.generated.h"
@@ -915,7 +915,7 @@ void preserve_exit(const char *errmsg)
       if (errmsg != NULL) {
         fprintf(stderr, "Nvim: preserving files...\n");
       }
-      ml_sync_all(false, false, true);  // preserve all swap files
+      ml_sync_all(false, false, true, false);  // preserve all swap files
       break;
     }
   }
@@ -179,6 +179,56 @@ static MTNode *id2node(MarkTree *b, uint64_t id)
   return pmap_get(uint64_t)(b->id2node, id);
 }
 
+static void ns_index_put(MarkTree *b, MTKey k)
+{
+  ptr_t *ref = pmap_put_ref(uint32_t)(b->ns_index, k.ns, NULL, NULL);
+  if (*ref == NULL) {
+    *ref = xcalloc(1, sizeof(Set(uint32_t)));
+  }
+  set_put(uint32_t, (Set(uint32_t) *)*ref, k.id);
+}
+
+static void ns_index_del(MarkTree *b, MTKey k)
+{
+  Set(uint32_t) *ids = pmap_get(uint32_t)(b->ns_index, k.ns);
+  if (ids == NULL) {
+    return;
+  }
+  set_del(uint32_t, ids, k.id);
+  if (set_size(ids) == 0) {
+    set_destroy(uint32_t, ids);
+    xfree(ids);
+    pmap_del(uint32_t)(b->ns_index, k.ns, NULL);
+  }
+}
+
+static void ns_index_clear(MarkTree *b)
+{
+  Set(uint32_t) *ids;
+  map_foreach_value(b->ns_index, ids, {
+    set_destroy(uint32_t, ids);
+    xfree(ids);
+  })
+  map_destroy(uint32_t, b->ns_index);
+}
+
+/// Ids of the marks in namespace "ns", without the end marks of pairs.
+///
+/// Must not be used while marks are added or deleted.
+///
+/// @return  NULL if there are no marks in "ns"
+Set(uint32_t) *marktree_ns_ids(MarkTree *b, uint32_t ns)
+{
+  return pmap_get(uint32_t)(b->ns_index, ns);
+}
+
+/// @return  number of marks in namespace "ns", not counting end marks
+size_t marktree_ns_count(MarkTree *b, uint32_t ns)
+{
+  Set(uint32_t) *ids = pmap_get(uint32_t)(b->ns_index, ns);
+  return ids ? set_size(ids) : 0;
+}
+
 #define ptr s->i_ptr
 #define meta s->i_meta
 // put functions
@@ -517,6 +567,9 @@ void marktree_put_key(MarkTree *b, MTKey k)
     b->meta_root[m] += meta_inc[m];
   }
   b->n_keys++;
+  if (!mt_end(k)) {
+    ns_index_put(b, k);
+  }
 }
 
 /// INITIATING DELETION PROTOCOL:
@@ -594,6 +647,9 @@ uint64_t marktree_del_itr(MarkTree *b, MarkTreeIter *itr, bool rev)
 
   b->n_keys--;
   pmap_del(uint64_t)(b->id2node, id, NULL);
+  if (!mt_end(raw)) {
+    ns_index_del(b, raw);
+  }
 
   // 4.
   // if (adjustment == 1) {
@@ -1295,6 +1351,7 @@ void marktree_clear(MarkTree *b)
     b->root = NULL;
   }
   map_destroy(uint64_t, b->id2node);
+  ns_index_clear(b);
   b->n_keys = 0;
   memset(b->meta_root, 0, kMTMetaCount * sizeof(b->meta_root[0]));
   assert(b->n_nodes == 0);
@@ -99,4 +99,5 @@ typedef struct {
   uint32_t meta_root[kMTMetaCount];
   size_t n_keys, n_nodes;
   PMap(uint64_t) id2node[1];
+  PMap(uint32_t) ns_index[1];  ///< namespace -> Set(uint32_t) of ids of marks in the tree
 } MarkTree;
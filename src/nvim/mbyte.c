@@ -30,6 +30,7 @@
 #include <locale.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -1215,6 +1216,39 @@ bool utf_printable(int c)
 
 #endif
 
+/// Get the number of printable ASCII characters (space to '~') at the start
+/// of "p", looking at no more than "len" bytes.  Each of them is a character
+/// of one cell, regardless of 'isprint' and 'ambiwidth', so a run of them
+/// can be handled in bulk.  The last one is not counted when it is followed
+/// by a byte that may start a composing character.
+size_t utf_ascii_run_len(const char *p, size_t len)
+  FUNC_ATTR_PURE FUNC_ATTR_NONNULL_ALL FUNC_ATTR_WARN_UNUSED_RESULT
+{
+  size_t n = 0;
+
+#ifdef __SSE2__
+  __m128i const lo = _mm_set1_epi8(' ' - 1);
+  __m128i const hi = _mm_set1_epi8(DEL);
+  // Bytes of 0x80 and above are negative and fail the first compare.
+  while (n + 16 <= len) {
+    __m128i const v = _mm_loadu_si128((const __m128i *)(p + n));
+    __m128i const ok = _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmplt_epi8(v, hi));
+    if (_mm_movemask_epi8(ok) != 0xffff) {
+      break;
+    }
+    n += 16;
+  }
+#endif
+
+  while (n < len && (uint8_t)p[n] >= ' ' && (uint8_t)p[n] < DEL) {
+    n++;
+  }
+  if (n > 0 && n < len && (uint8_t)p[n] >= 0x80) {
+    n--;
+  }
+  return n;
+}
+
 // Get class of a Unicode character.
 // 0: white space
 // 1: punctuation
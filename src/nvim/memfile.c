@@ -32,6 +32,7 @@
 /// mf_free()         remove a block
 /// mf_sync()         sync changed parts of memfile to disk
 /// mf_release_all()  release as much memory as possible
+/// mf_compress_unused()  compress blocks not used recently, when there is no file
 /// mf_trans_del()    may translate negative to positive block number
 /// mf_fullname()     make file name full path (use before first :cd)
 
@@ -50,6 +51,7 @@
 #include "nvim/fileio.h"
 #include "nvim/gettext_defs.h"
 #include "nvim/globals.h"
+#include "nvim/lz.h"
 #include "nvim/main.h"
 #include "nvim/map_defs.h"
 #include "nvim/memfile.h"
@@ -102,6 +104,7 @@ memfile_T *mf_open(char *fname, int flags)
 
   mfp->mf_free_first = NULL;         // free list is empty
   mfp->mf_dirty = MF_DIRTY_NO;
+  mfp->mf_fsync = NULL;
   mfp->mf_hash = (PMap(int64_t)) MAP_INIT;
   mfp->mf_trans = (Map(int64_t, int64_t)) MAP_INIT;
   mfp->mf_page_size = MEMFILE_PAGE_SIZE;
@@ -189,6 +192,7 @@ void mf_close(memfile_T *mfp, bool del_file)
   }
   map_destroy(int64_t, &mfp->mf_hash);
   map_destroy(int64_t, &mfp->mf_trans);  // free hashtable and its items
+  os_fsync_async_free(&mfp->mf_fsync);
   mf_free_fnames(mfp);
   xfree(mfp);
 }
@@ -266,7 +270,7 @@ bhdr_T *mf_new(memfile_T *mfp, bool negative, unsigned page_count)
       mfp->mf_blocknr_max += page_count;
     }
   }
-  hp->bh_flags = BH_LOCKED | BH_DIRTY;    // new block is always dirty
+  hp->bh_flags = BH_LOCKED | BH_DIRTY | BH_USED;    // new block is always dirty
   mfp->mf_dirty = MF_DIRTY_YES;
   hp->bh_page_count = page_count;
   pmap_put(int64_t)(&mfp->mf_hash, hp->bh_bnum, hp);
@@ -315,9 +319,12 @@ bhdr_T *mf_get(memfile_T *mfp, blocknr_T nr, unsigned page_count)
     }
   } else {
     pmap_del(int64_t)(&mfp->mf_hash, hp->bh_bnum, NULL);
+    if (hp->bh_flags & BH_COMPRESSED) {
+      mf_decompress(mfp, hp);
+    }
   }
 
-  hp->bh_flags |= BH_LOCKED;
+  hp->bh_flags |= BH_LOCKED | BH_USED;
   pmap_put(int64_t)(&mfp->mf_hash, hp->bh_bnum, hp);  // put in front of hash table
 
   return hp;
@@ -369,6 +376,8 @@ void mf_free(memfile_T *mfp, bhdr_T *hp)
 ///               MFS_FLUSH  Make sure buffers are flushed to disk, so they will
 ///                          survive a system crash.
 ///               MFS_ZERO   Only write block 0.
+///               MFS_FLUSH_ASYNC  Like MFS_FLUSH, but let the flush run in the
+///                          background without waiting for it.
 ///
 /// @return FAIL  If failure. Possible causes:
 ///               - No file (nothing to do).
@@ -431,6 +440,12 @@ int mf_sync(memfile_T *mfp, int flags)
     if (os_fsync(mfp->mf_fd)) {
       status = FAIL;
     }
+  } else if (flags & MFS_FLUSH_ASYNC) {
+    // The blocks have been written, only waiting for the disk is left.  An
+    // error shows up in the log, the next sync will try again.
+    if (os_fsync_async(&mfp->mf_fsync, mfp->mf_fd)) {
+      status = FAIL;
+    }
   }
 
   got_int |= got_int_save;
@@ -489,6 +504,56 @@ bool mf_release_all(void)
   return retval;
 }
 
+/// Compress the blocks that were not used since the previous call, to reduce
+/// memory use when there is no swapfile to move them to.  Blocks that don't
+/// compress well, locked blocks and block 0 are left alone.  mf_get()
+/// decompresses a block again when it is needed.
+void mf_compress_unused(memfile_T *mfp)
+{
+  if (mfp->mf_fd >= 0) {
+    return;
+  }
+  bhdr_T *hp;
+  map_foreach_value(&mfp->mf_hash, hp, {
+    if (hp->bh_flags & BH_USED) {
+      hp->bh_flags &= ~BH_USED;
+      continue;
+    }
+    if (hp->bh_bnum == 0 || (hp->bh_flags & (BH_LOCKED | BH_COMPRESSED))) {
+      continue;
+    }
+    size_t size = (size_t)mfp->mf_page_size * hp->bh_page_count;
+    // Only worth it when it saves at least a quarter.
+    size_t max_size = size - size / 4;
+    char *buf = xmalloc(sizeof(size_t) + max_size);
+    size_t len = lz_compress(hp->bh_data, size, buf + sizeof(size_t), max_size);
+    if (len == 0) {
+      xfree(buf);
+      continue;
+    }
+    memcpy(buf, &len, sizeof(size_t));
+    xfree(hp->bh_data);
+    hp->bh_data = xrealloc(buf, sizeof(size_t) + len);
+    hp->bh_flags |= BH_COMPRESSED;
+  })
+}
+
+/// Decompress a block compressed by mf_compress_unused().
+static void mf_decompress(memfile_T *mfp, bhdr_T *hp)
+{
+  size_t size = (size_t)mfp->mf_page_size * hp->bh_page_count;
+  char *data = xmalloc(size);
+  size_t len;
+  memcpy(&len, hp->bh_data, sizeof(size_t));
+  if (!lz_decompress((char *)hp->bh_data + sizeof(size_t), len, data, size)) {
+    siemsg("Corrupted compressed memfile block %" PRId64, (int64_t)hp->bh_bnum);
+    memset(data, 0, size);
+  }
+  xfree(hp->bh_data);
+  hp->bh_data = data;
+  hp->bh_flags &= ~BH_COMPRESSED;
+}
+
 /// Allocate a block header and a block of memory for it.
 static bhdr_T *mf_alloc_bhdr(memfile_T *mfp, unsigned page_count)
 {
@@ -590,6 +655,9 @@ static int mf_write(memfile_T *mfp, bhdr_T *hp)
     } else {
       hp2 = hp;
     }
+    if (hp2 != NULL && (hp2->bh_flags & BH_COMPRESSED)) {
+      mf_decompress(mfp, hp2);
+    }
 
     // TODO(elmart): Check (page_size * nr) within off_T bounds.
     off_T offset = (off_T)(page_size * nr);  // offset in the file
@@ -9,6 +9,7 @@ enum {
   MFS_STOP  = 2,  ///< stop syncing when a character is available
   MFS_FLUSH = 4,  ///< flushed file to disk
   MFS_ZERO  = 8,  ///< only write block 0
+  MFS_FLUSH_ASYNC = 16,  ///< like MFS_FLUSH, but don't wait for it
 };
 
 enum {
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 
 #include "nvim/map_defs.h"
+#include "nvim/os/fs_defs.h"
 
 /// A block number.
 ///
@@ -32,7 +33,9 @@ typedef struct {
 
 #define BH_DIRTY    1U
 #define BH_LOCKED   2U
-  unsigned bh_flags;                 ///< BH_DIRTY or BH_LOCKED
+#define BH_USED     4U               ///< used since the last mf_compress_unused()
+#define BH_COMPRESSED 8U             ///< bh_data holds compressed data
+  unsigned bh_flags;                 ///< BH_DIRTY, BH_LOCKED, BH_USED, BH_COMPRESSED
 } bhdr_T;
 
 typedef enum {
@@ -65,4 +68,5 @@ typedef struct {
   blocknr_T mf_infile_count;         ///< number of pages in the file
   unsigned mf_page_size;             ///< number of bytes in a page
   mfdirty_T mf_dirty;
+  FsyncReq *mf_fsync;                ///< fsync() running in the background
 } memfile_T;
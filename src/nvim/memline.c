@@ -294,6 +294,10 @@ int ml_open(buf_T *buf)
   buf->b_ml.ml_line_offset = 0;
   buf->b_ml.ml_chunksize = NULL;
   buf->b_ml.ml_usedchunks = 0;
+  buf->b_ml.ml_chunktree = NULL;
+  buf->b_ml.ml_chunktree_alloc = 0;
+  buf->b_ml.ml_chunktree_len = -1;
+  ml_prev_clear(buf);
 
   if (cmdmod.cmod_flags & CMOD_NOSWAPFILE) {
     buf->b_p_swf = false;
@@ -576,6 +580,9 @@ void ml_close(buf_T *buf, int del_file)
   }
   xfree(buf->b_ml.ml_stack);
   XFREE_CLEAR(buf->b_ml.ml_chunksize);
+  XFREE_CLEAR(buf->b_ml.ml_chunktree);
+  buf->b_ml.ml_chunktree_alloc = 0;
+  buf->b_ml.ml_chunktree_len = -1;
   buf->b_ml.ml_mfp = NULL;
 
   // Reset the "recovered" flag, give the ATTENTION prompt the next time
@@ -830,6 +837,7 @@ void ml_recover(bool checkext)
   buf->b_ml.ml_line_offset = 0;
   buf->b_ml.ml_locked = NULL;           // no locked block
   buf->b_ml.ml_flags = 0;
+  ml_prev_clear(buf);
 
   // open the memfile from the old swapfile
   char *p = xstrdup(fname_used);  // save "fname_used" for the message:
@@ -1709,7 +1717,10 @@ static int recov_file_names(char **names, char *path, bool prepend_dot)
 /// @param check_char  if true, stop syncing when character becomes available, but
 ///
 /// always sync at least one block.
-void ml_sync_all(int check_file, int check_char, bool do_fsync)
+/// @param do_fsync  if true, flush the swapfiles to disk.
+/// @param fsync_async  if true, don't wait for the flush to finish.  Blocks are
+///                     still written before returning.
+void ml_sync_all(int check_file, int check_char, bool do_fsync, bool fsync_async)
 {
   FOR_ALL_BUFFERS(buf) {
     if (buf->b_ml.ml_mfp == NULL || buf->b_ml.ml_mfp->mf_fname == NULL) {
@@ -1734,7 +1745,8 @@ void ml_sync_all(int check_file, int check_char, bool do_fsync)
     }
     if (buf->b_ml.ml_mfp->mf_dirty == MF_DIRTY_YES) {
       mf_sync(buf->b_ml.ml_mfp, (check_char ? MFS_STOP : 0)
-              | (do_fsync && bufIsChanged(buf) ? MFS_FLUSH : 0));
+              | (do_fsync && bufIsChanged(buf)
+                 ? (fsync_async ? MFS_FLUSH_ASYNC : MFS_FLUSH) : 0));
       if (check_char && os_char_avail()) {      // character available now
         break;
       }
@@ -1742,6 +1754,21 @@ void ml_sync_all(int check_file, int check_char, bool do_fsync)
   }
 }
 
+/// Compress memfile blocks not used for a while, for buffers without a
+/// swapfile.  These keep all their blocks in memory.  Called when idle.
+void ml_compress_all(void)
+{
+  FOR_ALL_BUFFERS(buf) {
+    memfile_T *mfp = buf->b_ml.ml_mfp;
+    if (mfp == NULL || mfp->mf_fd >= 0) {
+      continue;
+    }
+    // The cached line may point into a block that is not locked.
+    ml_flush_line(buf, false);
+    mf_compress_unused(mfp);
+  }
+}
+
 /// sync one buffer, including negative blocks
 ///
 /// after this all the blocks are in the swapfile
@@ -2490,6 +2517,38 @@ int ml_append_buf(buf_T *buf, linenr_T lnum, char *line, colnr_T len, bool newfi
   return ml_append_flush(buf, lnum, line, len, newfile ? ML_APPEND_NEW : 0);
 }
 
+/// Append "count" lines after "lnum" in "buf".  Like calling ml_append_buf()
+/// for each line, but the cached line is flushed only once, and the lengths
+/// don't have to be computed again when the caller knows them.  The buffer
+/// must already have a memline.
+///
+/// @param lnum   append after this line (can be 0)
+/// @param lines  text of the new lines
+/// @param lens   lengths of the new lines, excluding NUL, or NULL
+/// @param count  number of lines in "lines"
+///
+/// @return  number of lines appended, less than "count" for failure
+size_t ml_append_buf_lines(buf_T *buf, linenr_T lnum, char **lines, const size_t *lens,
+                           size_t count)
+  FUNC_ATTR_NONNULL_ARG(1)
+{
+  if (buf->b_ml.ml_mfp == NULL || lnum > buf->b_ml.ml_line_count) {
+    return 0;
+  }
+  if (buf->b_ml.ml_line_lnum != 0) {
+    ml_flush_line(buf, false);
+  }
+
+  size_t i;
+  for (i = 0; i < count; i++) {
+    colnr_T len = lens != NULL ? (colnr_T)lens[i] + 1 : 0;
+    if (ml_append_int(buf, lnum + (linenr_T)i, lines[i], len, 0) == FAIL) {
+      break;
+    }
+  }
+  return i;
+}
+
 void ml_add_deleted_len(char *ptr, ssize_t len)
 {
   ml_add_deleted_len_buf(curbuf, ptr, len);
@@ -2984,6 +3043,66 @@ static bhdr_T *ml_new_ptr(memfile_T *mfp)
   return hp;
 }
 
+/// Forget the data blocks remembered by ml_find_line(), after line numbers or
+/// pointer blocks may have changed.
+static void ml_prev_clear(buf_T *buf)
+{
+  for (int i = 0; i < MLPREV_COUNT; i++) {
+    buf->b_ml.ml_prev[i].mp_bnum = 0;
+  }
+  buf->b_ml.ml_prev_next = 0;
+}
+
+/// Remember the data block that ml_find_line() just locked, and the stack
+/// leading to it.
+static void ml_prev_add(buf_T *buf, bhdr_T *hp)
+{
+  if (buf->b_ml.ml_stack_top > MLPREV_STACK_SIZE) {
+    return;
+  }
+  mlprev_T *mp = &buf->b_ml.ml_prev[buf->b_ml.ml_prev_next];
+  buf->b_ml.ml_prev_next = (buf->b_ml.ml_prev_next + 1) % MLPREV_COUNT;
+  mp->mp_bnum = hp->bh_bnum;
+  mp->mp_page_count = hp->bh_page_count;
+  mp->mp_low = buf->b_ml.ml_locked_low;
+  mp->mp_high = buf->b_ml.ml_locked_high;
+  mp->mp_stack_top = buf->b_ml.ml_stack_top;
+  memcpy(mp->mp_stack, buf->b_ml.ml_stack, sizeof(infoptr_T) * (size_t)mp->mp_stack_top);
+}
+
+/// Lock a remembered data block containing line "lnum", if there is one.
+///
+/// @return  NULL if not found, pointer to block header otherwise
+static bhdr_T *ml_prev_find(buf_T *buf, linenr_T lnum)
+{
+  for (int i = 0; i < MLPREV_COUNT; i++) {
+    mlprev_T *mp = &buf->b_ml.ml_prev[i];
+    if (mp->mp_bnum == 0 || lnum < mp->mp_low || lnum > mp->mp_high) {
+      continue;
+    }
+    bhdr_T *hp = mf_get(buf->b_ml.ml_mfp, mp->mp_bnum, mp->mp_page_count);
+    if (hp != NULL) {
+      DataBlock *dp = hp->bh_data;
+      if (dp->db_id == DATA_ID
+          && (linenr_T)dp->db_line_count == mp->mp_high - mp->mp_low + 1) {
+        memcpy(buf->b_ml.ml_stack, mp->mp_stack, sizeof(infoptr_T) * (size_t)mp->mp_stack_top);
+        buf->b_ml.ml_stack_top = mp->mp_stack_top;
+        buf->b_ml.ml_locked = hp;
+        buf->b_ml.ml_locked_low = mp->mp_low;
+        buf->b_ml.ml_locked_high = mp->mp_high;
+        buf->b_ml.ml_locked_lineadd = 0;
+        buf->b_ml.ml_flags &= ~(ML_LOCKED_DIRTY | ML_LOCKED_POS);
+        return hp;
+      }
+      mf_put(buf->b_ml.ml_mfp, hp, false, false);
+    }
+    // The block moved, e.g. it got a positive number when written to the
+    // swapfile.
+    mp->mp_bnum = 0;
+  }
+  return NULL;
+}
+
 /// Lookup line 'lnum' in a memline.
 ///
 /// @param action: if ML_DELETE or ML_INSERT the line count is updated while searching
@@ -3004,6 +3123,11 @@ static bhdr_T *ml_find_line(buf_T *buf, linenr_T lnum, int action)
 
   memfile_T *mfp = buf->b_ml.ml_mfp;
 
+  if (action != ML_FIND) {
+    // Line numbers will change, or blocks are written to the swapfile.
+    ml_prev_clear(buf);
+  }
+
   // If there is a locked block check if the wanted line is in it.
   // If not, flush and release the locked block.
   // Don't do this for ML_INSERT_SAME, because the stack need to be updated.
@@ -3045,7 +3169,12 @@ static bhdr_T *ml_find_line(buf_T *buf, linenr_T lnum, int action)
   linenr_T low = 1;
   linenr_T high = buf->b_ml.ml_line_count;
 
-  if (action == ML_FIND) {      // first try stack entries
+  if (action == ML_FIND) {
+    // Try a recently used data block, then stack entries.
+    if ((hp = ml_prev_find(buf, lnum)) != NULL) {
+      return hp;
+    }
+    g_stats.ml_find_line++;
     for (top = buf->b_ml.ml_stack_top - 1; top >= 0; top--) {
       infoptr_T *ip = &(buf->b_ml.ml_stack[top]);
       if (ip->ip_low <= lnum && ip->ip_high >= lnum) {
@@ -3082,6 +3211,9 @@ static bhdr_T *ml_find_line(buf_T *buf, linenr_T lnum, int action)
       buf->b_ml.ml_locked_high = high;
       buf->b_ml.ml_locked_lineadd = 0;
       buf->b_ml.ml_flags &= ~(ML_LOCKED_DIRTY | ML_LOCKED_POS);
+      if (action == ML_FIND) {
+        ml_prev_add(buf, hp);
+      }
       return hp;
     }
 
@@ -3825,6 +3957,95 @@ enum {
   MLCS_MINL = 400,  // should be half of MLCS_MAXL
 };
 
+/// Mark the Fenwick tree over the chunk sizes as stale, after chunks were
+/// split, merged or reset.  It is rebuilt by the next lookup.
+static inline void ml_chunktree_invalidate(buf_T *buf)
+{
+  buf->b_ml.ml_chunktree_len = -1;
+}
+
+/// Rebuild the Fenwick tree over the chunk sizes, if it is stale.  O(n).
+static void ml_chunktree_build(buf_T *buf)
+{
+  memline_T *ml = &buf->b_ml;
+  int n = ml->ml_usedchunks;
+  if (ml->ml_chunktree_len == n) {
+    return;
+  }
+  if (ml->ml_chunktree_alloc < n + 1) {
+    ml->ml_chunktree_alloc = MAX(ml->ml_numchunks, n) + 1;
+    ml->ml_chunktree = xrealloc(ml->ml_chunktree,
+                                sizeof(chunksize_T) * (size_t)ml->ml_chunktree_alloc);
+  }
+  chunksize_T *tree = ml->ml_chunktree;
+  memcpy(tree + 1, ml->ml_chunksize, sizeof(chunksize_T) * (size_t)n);
+  for (int i = 1; i <= n; i++) {
+    int parent = i + (i & -i);
+    if (parent <= n) {
+      tree[parent].mlcs_numlines += tree[i].mlcs_numlines;
+      tree[parent].mlcs_totalsize += tree[i].mlcs_totalsize;
+    }
+  }
+  ml->ml_chunktree_len = n;
+}
+
+/// Add "numlines" and "totalsize" to chunk "idx" in the Fenwick tree.
+/// Does nothing when the tree is stale, it will be rebuilt anyway.
+static void ml_chunktree_add(buf_T *buf, int idx, int numlines, int totalsize)
+{
+  memline_T *ml = &buf->b_ml;
+  if (ml->ml_chunktree_len != ml->ml_usedchunks) {
+    return;
+  }
+  for (int i = idx + 1; i <= ml->ml_chunktree_len; i += i & -i) {
+    ml->ml_chunktree[i].mlcs_numlines += numlines;
+    ml->ml_chunktree[i].mlcs_totalsize += totalsize;
+  }
+}
+
+/// Find the chunks that come before the one containing line "lnum" or byte
+/// "offset".  The last chunk never qualifies.
+///
+/// @param lnum    if > 0, skip chunks ending before this line
+/// @param offset  if > 0, skip chunks ending before this byte offset
+/// @param ffdos   count one extra byte per line for offset
+/// @param[out] linesp  number of lines in the skipped chunks
+/// @param[out] sizep   number of bytes in the skipped chunks, without CRs
+///
+/// @return  number of skipped chunks, i.e. index of the found chunk
+static int ml_chunktree_find(buf_T *buf, linenr_T lnum, int offset, int ffdos, linenr_T *linesp,
+                             int *sizep)
+{
+  ml_chunktree_build(buf);
+
+  memline_T *ml = &buf->b_ml;
+  int n = ml->ml_usedchunks - 1;
+  int idx = 0;
+  linenr_T lines = 0;
+  int size = 0;
+  int step = 1;
+  while (step * 2 <= n) {
+    step *= 2;
+  }
+  for (; step > 0; step /= 2) {
+    if (idx + step > n) {
+      continue;
+    }
+    chunksize_T *node = &ml->ml_chunktree[idx + step];
+    linenr_T next_lines = lines + node->mlcs_numlines;
+    int next_size = size + node->mlcs_totalsize;
+    if ((lnum != 0 && lnum > next_lines)
+        || (offset != 0 && offset > next_size + ffdos * next_lines)) {
+      idx += step;
+      lines = next_lines;
+      size = next_size;
+    }
+  }
+  *linesp = lines;
+  *sizep = size;
+  return idx;
+}
+
 /// Keep information for finding byte offset of a line
 ///
 /// @param updtype  may be one of:
@@ -3852,6 +4073,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     buf->b_ml.ml_usedchunks = 1;
     buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
     buf->b_ml.ml_chunksize[0].mlcs_totalsize = 1;
+    ml_chunktree_invalidate(buf);
   }
 
   if (updtype == ML_CHNK_UPDLINE && buf->b_ml.ml_line_count == 1) {
@@ -3859,6 +4081,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     buf->b_ml.ml_usedchunks = 1;
     buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
     buf->b_ml.ml_chunksize[0].mlcs_totalsize = buf->b_ml.ml_line_textlen;
+    ml_chunktree_invalidate(buf);
     return;
   }
 
@@ -3866,13 +4089,9 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
   // chunk.
   if (buf != ml_upd_lastbuf || line != ml_upd_lastline + 1
       || updtype != ML_CHNK_ADDLINE) {
-    for (curline = 1, curix = 0;
-         curix < buf->b_ml.ml_usedchunks - 1
-         && line >= curline +
-         buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-         curix++) {
-      curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-    }
+    int size;
+    curix = ml_chunktree_find(buf, line, 0, 0, &curline, &size);
+    curline++;
   } else if (curix < buf->b_ml.ml_usedchunks - 1
              && line >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines) {
     // Adjust cached curix & curline
@@ -3885,6 +4104,8 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     len = -len;
   }
   curchnk->mlcs_totalsize += len;
+  ml_chunktree_add(buf, curix,
+                   updtype == ML_CHNK_ADDLINE ? 1 : updtype == ML_CHNK_DELLINE ? -1 : 0, len);
   if (updtype == ML_CHNK_ADDLINE) {
     int rest;
     DataBlock *dp;
@@ -3901,6 +4122,8 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
       int end_idx;
       int text_end;
 
+      ml_chunktree_invalidate(buf);
+
       memmove(buf->b_ml.ml_chunksize + curix + 1,
               buf->b_ml.ml_chunksize + curix,
               (size_t)(buf->b_ml.ml_usedchunks - curix) * sizeof(chunksize_T));
@@ -3948,6 +4171,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
       // after this. Do it now to avoid the loop above later on
       curchnk = buf->b_ml.ml_chunksize + curix + 1;
       buf->b_ml.ml_usedchunks++;
+      ml_chunktree_invalidate(buf);
       if (line == buf->b_ml.ml_line_count) {
         curchnk->mlcs_numlines = 0;
         curchnk->mlcs_totalsize = 0;
@@ -3982,6 +4206,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
       curchnk = buf->b_ml.ml_chunksize + curix;
     } else if (curix == 0 && curchnk->mlcs_numlines <= 0) {
       buf->b_ml.ml_usedchunks--;
+      ml_chunktree_invalidate(buf);
       memmove(buf->b_ml.ml_chunksize, buf->b_ml.ml_chunksize + 1,
               (size_t)buf->b_ml.ml_usedchunks * sizeof(chunksize_T));
       return;
@@ -3996,6 +4221,7 @@ static void ml_updatechunk(buf_T *buf, linenr_T line, int len, int updtype)
     curchnk[-1].mlcs_numlines += curchnk->mlcs_numlines;
     curchnk[-1].mlcs_totalsize += curchnk->mlcs_totalsize;
     buf->b_ml.ml_usedchunks--;
+    ml_chunktree_invalidate(buf);
     if (curix < buf->b_ml.ml_usedchunks) {
       memmove(buf->b_ml.ml_chunksize + curix,
               buf->b_ml.ml_chunksize + curix + 1,
@@ -4065,23 +4291,13 @@ int ml_find_line_or_offset(buf_T *buf, linenr_T lnum, int *offp, bool no_ff)
   }
   // Find the last chunk before the one containing our line. Last chunk is
   // special because it will never qualify.
-  linenr_T curline = 1;
-  int curix = 0;
-  int size = 0;
-  while (curix < buf->b_ml.ml_usedchunks - 1
-         && ((lnum != 0
-              && lnum >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines)
-             || (offset != 0
-                 && offset > size +
-                 buf->b_ml.ml_chunksize[curix].mlcs_totalsize
-                 + ffdos * buf->b_ml.ml_chunksize[curix].mlcs_numlines))) {
-    curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-    size += buf->b_ml.ml_chunksize[curix].mlcs_totalsize;
-    if (offset && ffdos) {
-      size += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-    }
-    curix++;
+  linenr_T curline;
+  int size;
+  ml_chunktree_find(buf, lnum, offset, ffdos, &curline, &size);
+  if (offset && ffdos) {
+    size += curline;
   }
+  curline++;
 
   while ((lnum != 0 && curline < lnum) || (offset != 0 && size < offset)) {
     if (curline > buf->b_ml.ml_line_count
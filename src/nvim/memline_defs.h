@@ -15,6 +15,22 @@ typedef struct {
   int ip_index;                 // index for block with current lnum
 } infoptr_T;    // block/index pair
 
+/// A data block that was found before, with the stack of pointer blocks that
+/// leads to it.  Lets ml_find_line() go back to a recently used block without
+/// walking down the tree, e.g. when a multi-line regexp match or a search
+/// alternates between lines in different blocks.
+typedef struct {
+  blocknr_T mp_bnum;            // block number, 0 if not valid
+  unsigned mp_page_count;       // number of pages in the block
+  linenr_T mp_low;              // lowest lnum in the block
+  linenr_T mp_high;             // highest lnum in the block
+  int mp_stack_top;             // number of entries in mp_stack
+#define MLPREV_STACK_SIZE 6
+  infoptr_T mp_stack[MLPREV_STACK_SIZE];
+} mlprev_T;
+
+#define MLPREV_COUNT 4          // number of remembered data blocks
+
 typedef struct {
   int mlcs_numlines;
   int mlcs_totalsize;
@@ -34,6 +50,9 @@ typedef struct {
 ///
 /// Memline also has "chunks" of 800 lines that are separate from the 128-tree
 /// structure, primarily used to speed up line2byte() and byte2line().
+/// A Fenwick tree over the chunk sizes makes finding the chunk containing a
+/// line or byte offset O(log n).  It is rebuilt lazily when chunks are split
+/// or merged.
 ///
 /// Motivation: If you have a file that is 10000 lines long, and you insert
 ///             a line at linenr 1000, you don't want to move 9000 lines in
@@ -67,7 +86,12 @@ typedef struct {
   linenr_T ml_locked_low;       // first line in ml_locked
   linenr_T ml_locked_high;      // last line in ml_locked
   int ml_locked_lineadd;        // number of lines inserted in ml_locked
+  mlprev_T ml_prev[MLPREV_COUNT];  // recently found data blocks
+  int ml_prev_next;             // entry in ml_prev to overwrite next
   chunksize_T *ml_chunksize;
   int ml_numchunks;
   int ml_usedchunks;
+  chunksize_T *ml_chunktree;    // Fenwick tree over ml_chunksize, 1-based
+  int ml_chunktree_alloc;       // allocated entries in ml_chunktree
+  int ml_chunktree_len;         // chunks in ml_chunktree, -1 if it needs a rebuild
 } memline_T;
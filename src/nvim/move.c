@@ -548,6 +548,7 @@ void check_cursor_moved(win_T *wp)
 // be redrawn.  E.g, when changing the 'wrap' option or folding.
 void changed_window_setting(win_T *wp)
 {
+  linesize_cache_invalidate();
   wp->w_lines_valid = 0;
   changed_line_abv_curs_win(wp);
   wp->w_valid &= ~(VALID_BOTLINE|VALID_BOTLINE_AP|VALID_TOPLINE);
@@ -29,6 +29,7 @@
 #include "nvim/msgpack_rpc/packer_defs.h"
 #include "nvim/msgpack_rpc/unpacker.h"
 #include "nvim/os/input.h"
+#include "nvim/os/time.h"
 #include "nvim/types_defs.h"
 #include "nvim/ui.h"
 #include "nvim/ui_client.h"
@@ -254,6 +255,7 @@ static void parse_msgpack(Channel *channel)
         } else if (p->ui_handler.fn != NULL && p->result.type == kObjectTypeArray) {
           p->ui_handler.fn(p->result.data.array);
         }
+        ui_client_redraw_event_done(p->ui_handler.fn == ui_client_event_flush);
       }
       arena_mem_free(arena_finish(&p->arena));
     } else if (p->type == kMessageTypeResponse) {
@@ -298,6 +300,10 @@ static void parse_msgpack(Channel *channel)
     }
   }
 
+  if (ui_client_attached) {
+    ui_client_flush_frame();
+  }
+
   if (unpacker_closed(p)) {
     chan_close_on_err(channel, p->unpack_error.msg, LOGLVL_INF);
     api_clear_error(&p->unpack_error);
@@ -325,6 +331,7 @@ static void handle_request(Channel *channel, Unpacker *p, Array args)
   evdata->used_mem = p->arena;
   p->arena = (Arena)ARENA_EMPTY;
   evdata->request_id = p->request_id;
+  evdata->received = os_hrtime();
   channel_incref(channel);
   if (p->handler.fast) {
     bool is_get_mode = p->handler.fn == handle_nvim_get_mode;
@@ -363,7 +370,10 @@ static void request_event(void **argv)
     goto free_ret;
   }
 
+  uint64_t start = os_hrtime();
   Object result = handler.fn(channel->id, e->args, &e->used_mem, &error);
+  latency_add(channel->rpc.latency.queued, start - e->received);
+  latency_add(channel->rpc.latency.exec, os_hrtime() - start);
   if (e->type == kMessageTypeRequest || ERROR_SET(&error)) {
     // Send the response.
     serialize_response(channel, e->handler, e->type, e->request_id, &error, &result);
@@ -380,32 +390,76 @@ free_ret:
   api_clear_error(&error);
 }
 
-bool rpc_write_raw(uint64_t id, WBuffer *buffer)
+static void latency_add(uint32_t *hist, uint64_t ns)
+{
+  int i = 0;
+  for (uint64_t us = ns / 1000; us > 0 && i < RPC_LATENCY_BUCKETS - 1; us >>= 1) {
+    i++;
+  }
+  hist[i]++;
+}
+
+/// Gets the request latency histograms of RPC channel "id".
+///
+/// @return  false if "id" is not an open RPC channel
+bool rpc_latency_info(uint64_t id, Dict *rv, Arena *arena)
+{
+  Channel *channel = find_rpc_channel(id);
+  if (!channel) {
+    return false;
+  }
+  RpcLatency *l = &channel->rpc.latency;
+  Array queued = arena_array(arena, RPC_LATENCY_BUCKETS);
+  Array exec = arena_array(arena, RPC_LATENCY_BUCKETS);
+  for (size_t i = 0; i < RPC_LATENCY_BUCKETS; i++) {
+    ADD_C(queued, INTEGER_OBJ(l->queued[i]));
+    ADD_C(exec, INTEGER_OBJ(l->exec[i]));
+  }
+  *rv = arena_dict(arena, 2);
+  PUT_C(*rv, "queued", ARRAY_OBJ(queued));
+  PUT_C(*rv, "exec", ARRAY_OBJ(exec));
+  return true;
+}
+
+/// Writes already serialized data to a channel. Several buffers are written
+/// with a single write request.
+bool rpc_write_raw(uint64_t id, WBuffer **buffers, size_t nbufs)
 {
   Channel *channel = find_rpc_channel(id);
   if (!channel) {
-    wstream_release_wbuffer(buffer);
+    for (size_t i = 0; i < nbufs; i++) {
+      wstream_release_wbuffer(buffers[i]);
+    }
     return false;
   }
 
-  return channel_write(channel, buffer);
+  return channel_writev(channel, buffers, nbufs);
 }
 
 static bool channel_write(Channel *channel, WBuffer *buffer)
+{
+  return channel_writev(channel, &buffer, 1);
+}
+
+static bool channel_writev(Channel *channel, WBuffer **buffers, size_t nbufs)
 {
   int err = 0;
 
   if (channel->rpc.closed) {
-    wstream_release_wbuffer(buffer);
+    for (size_t i = 0; i < nbufs; i++) {
+      wstream_release_wbuffer(buffers[i]);
+    }
     return false;
   }
 
   if (channel->streamtype == kChannelStreamInternal) {
-    channel_incref(channel);
-    CREATE_EVENT(channel->events, internal_read_event, channel, buffer);
+    for (size_t i = 0; i < nbufs; i++) {
+      channel_incref(channel);
+      CREATE_EVENT(channel->events, internal_read_event, channel, buffers[i]);
+    }
   } else {
     Stream *in = channel_instream(channel);
-    err = wstream_write(in, buffer);
+    err = wstream_writev(in, buffers, nbufs);
   }
 
   if (err != 0) {
@@ -614,7 +668,7 @@ static void packer_buffer_init_channels(Channel **chans, size_t nchans, PackerBu
 {
   for (size_t i = 0; i < nchans; i++) {
     Channel *chan = chans[i];
-    if (chan->rpc.ui && chan->rpc.ui->incomplete_event) {
+    if (chan->rpc.ui && (chan->rpc.ui->incomplete_event || chan->rpc.ui->npending_bufs)) {
       remote_ui_flush_pending_data(chan->rpc.ui);
     }
   }
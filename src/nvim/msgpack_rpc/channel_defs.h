@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <uv.h>
 
 #include "nvim/api/private/dispatch.h"
@@ -34,8 +35,19 @@ typedef struct {
   Array args;
   uint32_t request_id;
   Arena used_mem;
+  uint64_t received;  ///< os_hrtime() when the request was parsed
 } RequestEvent;
 
+enum { RPC_LATENCY_BUCKETS = 21, };
+
+/// Histograms of the time taken by requests handled on a channel. Bucket "i"
+/// counts requests that took less than 2^i microseconds, the last bucket also
+/// counts the slower ones.
+typedef struct {
+  uint32_t queued[RPC_LATENCY_BUCKETS];  ///< from parsing until the handler ran
+  uint32_t exec[RPC_LATENCY_BUCKETS];  ///< in the handler
+} RpcLatency;
+
 typedef struct {
   bool closed;
   Unpacker *unpacker;
@@ -44,4 +56,5 @@ typedef struct {
   kvec_t(ChannelCallFrame *) call_stack;
   Dict info;
   ClientType client_type;
+  RpcLatency latency;
 } RpcState;
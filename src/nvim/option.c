@@ -93,6 +93,7 @@
 #include "nvim/os/os.h"
 #include "nvim/os/os_defs.h"
 #include "nvim/path.h"
+#include "nvim/plines.h"
 #include "nvim/popupmenu.h"
 #include "nvim/pos_defs.h"
 #include "nvim/regexp.h"
@@ -2996,6 +2997,7 @@ void check_redraw_for(buf_T *buf, win_T *win, uint32_t flags)
     redraw_buf_later(buf, UPD_NOT_VALID);
   }
   if (all) {
+    linesize_cache_invalidate();
     redraw_all_later(UPD_NOT_VALID);
   }
 }
@@ -9049,6 +9049,8 @@ local options = {
         Careful: All text will be in memory:
         	- Don't use this for big files.
         	- Recovery will be impossible!
+        Text that was not used for a while is compressed in memory when
+        Nvim is idle for 'updatetime'.
         A swapfile will only be present when 'updatecount' is non-zero and
         'swapfile' is set.
         When 'swapfile' is reset, the swap file for the current buffer is
@@ -41,6 +41,7 @@
 #include "nvim/globals.h"
 #include "nvim/log.h"
 #include "nvim/macros_defs.h"
+#include "nvim/main.h"
 #include "nvim/memory.h"
 #include "nvim/message.h"
 #include "nvim/option_vars.h"
@@ -745,6 +746,97 @@ int os_fsync(int fd)
   return r;
 }
 
+/// Flushes file modifications to disk without waiting for it.
+///
+/// The fsync() runs in the libuv threadpool on a duplicate of `fd`, so `fd`
+/// may be closed before it finishes.  When a sync is still running for `*reqp`
+/// another one is done after it, to include any writes done in the meantime.
+///
+/// @param[in,out] reqp  request state, allocated when NULL. Release it with
+///                      os_fsync_async_free().
+/// @param fd the file descriptor of the file to flush to disk.
+///
+/// @return 0 when the sync was started or queued, or libuv error code.
+int os_fsync_async(FsyncReq **reqp, int fd)
+  FUNC_ATTR_NONNULL_ALL
+{
+  if (*reqp == NULL) {
+    *reqp = xcalloc(1, sizeof(FsyncReq));
+  }
+  FsyncReq *fr = *reqp;
+  if (fr->busy) {
+    fr->again = true;
+    return 0;
+  }
+  int dup_fd = os_dup(fd);
+  if (dup_fd < 0) {
+    return dup_fd;
+  }
+  fr->fd = dup_fd;
+  fr->busy = true;
+  fr->again = false;
+  fr->req.data = fr;
+  int r = uv_fs_fsync(&main_loop.uv, &fr->req, fr->fd, fsync_async_cb);
+  if (r < 0) {
+    os_close(fr->fd);
+    fr->busy = false;
+  }
+  return r;
+}
+
+static void fsync_async_cb(uv_fs_t *req)
+{
+  FsyncReq *fr = req->data;
+  if (req->result < 0) {
+    ELOG("fsync() failed: %s", uv_strerror((int)req->result));
+  }
+  g_stats.fsync++;
+  uv_fs_req_cleanup(req);
+  if (fr->again && !fr->orphan) {
+    fr->again = false;
+    if (uv_fs_fsync(&main_loop.uv, &fr->req, fr->fd, fsync_async_cb) == 0) {
+      return;
+    }
+  }
+  os_close(fr->fd);
+  fr->busy = false;
+  if (fr->orphan) {
+    xfree(fr);
+  }
+}
+
+/// Releases the state of os_fsync_async().  A running sync is not cancelled,
+/// the state is freed when it is done.
+void os_fsync_async_free(FsyncReq **reqp)
+  FUNC_ATTR_NONNULL_ALL
+{
+  FsyncReq *fr = *reqp;
+  *reqp = NULL;
+  if (fr == NULL) {
+    return;
+  }
+  if (fr->busy) {
+    fr->orphan = true;
+  } else {
+    xfree(fr);
+  }
+}
+
+/// Tells the OS that file `fd` will be read once, from start to end.
+///
+/// Lets the kernel use a larger readahead window, so reading a huge file does
+/// not stall on every read(). Only a hint: does nothing where unsupported.
+///
+/// @param fd the file descriptor of a regular file.
+void os_fadvise_sequential(int fd)
+{
+#ifdef HAVE_POSIX_FADVISE
+  (void)posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#else
+  (void)fd;
+#endif
+}
+
 /// Get stat information for a file.
 ///
 /// @return libuv return code, or -errno
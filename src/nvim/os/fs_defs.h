@@ -20,6 +20,15 @@ typedef struct {
   uv_dirent_t ent;  ///< @private The entry information.
 } Directory;
 
+/// An fsync() running in the libuv threadpool, see os_fsync_async().
+typedef struct {
+  uv_fs_t req;  ///< @private
+  int fd;       ///< @private Duplicate of the file descriptor being synced.
+  bool busy;    ///< @private "req" is in the threadpool.
+  bool again;   ///< @private Another sync was requested while busy.
+  bool orphan;  ///< @private Owner is gone, free when done.
+} FsyncReq;
+
 // Values returned by os_nodetype()
 #define NODE_NORMAL     0  // file or directory, check with os_isdir()
 #define NODE_WRITABLE   1  // something we can write to (character
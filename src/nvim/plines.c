@@ -2,6 +2,7 @@
 
 #include <limits.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -16,12 +17,14 @@
 #include "nvim/fold.h"
 #include "nvim/globals.h"
 #include "nvim/indent.h"
+#include "nvim/klib/kvec.h"
 #include "nvim/macros_defs.h"
 #include "nvim/mark_defs.h"
 #include "nvim/marktree.h"
 #include "nvim/mbyte.h"
 #include "nvim/mbyte_defs.h"
 #include "nvim/memline.h"
+#include "nvim/memory.h"
 #include "nvim/move.h"
 #include "nvim/option.h"
 #include "nvim/option_vars.h"
@@ -31,8 +34,53 @@
 #include "nvim/state_defs.h"
 #include "nvim/types_defs.h"
 
+enum {
+  LINESIZE_CACHE_SIZE = 8,       ///< number of cached lines per window
+  LINESIZE_CACHE_MINLEN = 1000,  ///< shorter lines are not cached
+  LINESIZE_STEP = 256,           ///< bytes between positions in LineSizeEntry
+};
+
+/// Everything the size of a line depends on, besides its text and inline
+/// virtual text.
+typedef struct {
+  handle_T buf;
+  varnumber_T changedtick;
+  unsigned generation;  ///< see linesize_cache_invalidate()
+  OptInt ts;
+  const colnr_T *vts_array;
+  const char *sbr;
+  int width1;           ///< width of the first screen line, zero without 'wrap'
+  int width2;           ///< width of the other screen lines, zero without 'wrap'
+  bool use_tabstop;
+  bool list;
+  bool lbr;
+  bool bri;
+  CSType cstype;
+} LineSizeKey;
+
+/// Virtual column at the start of the character at byte "col".
+typedef struct {
+  colnr_T col;
+  colnr_T vcol;
+} LineSizePos;
+
+typedef struct {
+  linenr_T lnum;  ///< zero when not used
+  LineSizeKey key;
+  int size;       ///< size of the whole line, -1 when not computed yet
+  /// For kCharsizeFast: the first character at or after every
+  /// LINESIZE_STEP bytes, for getvcol() to start from.
+  kvec_t(LineSizePos) pos;
+} LineSizeEntry;
+
+struct linesize_cache {
+  LineSizeEntry entries[LINESIZE_CACHE_SIZE];
+};
+
 #include "plines.c.generated.h"
 
+static unsigned linesize_generation = 0;
+
 /// Functions calculating horizontal size of text, when displayed in a window.
 
 /// Return the number of cells the first char in "p" will take on the screen,
@@ -76,7 +124,9 @@ int linetabsize_col(int startvcol, char *s)
 /// Doesn't count the size of 'listchars' "eol".
 int linetabsize(win_T *wp, linenr_T lnum)
 {
-  return win_linetabsize(wp, lnum, ml_get_buf(wp->w_buffer, lnum), MAXCOL);
+  CharsizeArg csarg;
+  CSType const cstype = init_charsize_arg(&csarg, wp, lnum, ml_get_buf(wp->w_buffer, lnum));
+  return linesize_line(wp, lnum, &csarg, cstype);
 }
 
 /// Like linetabsize(), but counts the size of 'listchars' "eol".
@@ -88,6 +138,87 @@ int linetabsize_eol(win_T *wp, linenr_T lnum)
 
 static const uint32_t inline_filter[kMTMetaCount] = {[kMTMetaInline] = kMTFilterSelect };
 
+/// Invalidate the cached sizes of lines in all windows.  Needed when
+/// something changes the size of text that is not checked by
+/// linesize_cache_get(), such as an option or inline virtual text.
+void linesize_cache_invalidate(void)
+{
+  linesize_generation++;
+}
+
+/// Free the cached line sizes of window "wp".
+void linesize_cache_free(win_T *wp)
+{
+  if (wp->w_linesize_cache == NULL) {
+    return;
+  }
+  for (int i = 0; i < LINESIZE_CACHE_SIZE; i++) {
+    kv_destroy(wp->w_linesize_cache->entries[i].pos);
+  }
+  XFREE_CLEAR(wp->w_linesize_cache);
+}
+
+/// Get the cache entry for line "lnum" of window "wp", prepared by
+/// init_charsize_arg().  The entry is reset when the line or its layout
+/// changed.
+///
+/// @return  NULL when the line is too short to be worth caching.
+static LineSizeEntry *linesize_cache_get(win_T *wp, linenr_T lnum, const CharsizeArg *csarg,
+                                         CSType cstype)
+{
+  if (lnum <= 0 || ml_get_buf_len(wp->w_buffer, lnum) < LINESIZE_CACHE_MINLEN) {
+    return NULL;
+  }
+
+  LineSizeKey key;
+  memset(&key, 0, sizeof(key));  // padding is compared too
+  key.buf = wp->w_buffer->handle;
+  key.changedtick = buf_get_changedtick(wp->w_buffer);
+  key.generation = linesize_generation;
+  key.ts = wp->w_buffer->b_p_ts;
+  key.vts_array = wp->w_buffer->b_p_vts_array;
+  key.sbr = get_showbreak_value(wp);
+  if (wp->w_p_wrap) {
+    key.width1 = wp->w_view_width - win_col_off(wp);
+    key.width2 = key.width1 + win_col_off2(wp);
+  }
+  key.use_tabstop = csarg->use_tabstop;
+  key.list = wp->w_p_list;
+  key.lbr = wp->w_p_lbr;
+  key.bri = wp->w_p_bri;
+  key.cstype = cstype;
+
+  if (wp->w_linesize_cache == NULL) {
+    wp->w_linesize_cache = xcalloc(1, sizeof(*wp->w_linesize_cache));
+  }
+  LineSizeEntry *e = &wp->w_linesize_cache->entries[lnum % LINESIZE_CACHE_SIZE];
+  if (e->lnum != lnum || memcmp(&e->key, &key, sizeof(key)) != 0) {
+    e->lnum = lnum;
+    e->key = key;
+    e->size = -1;
+    kv_size(e->pos) = 0;
+  }
+  return e;
+}
+
+/// Get the size of line "lnum" as linesize_fast() or linesize_regular()
+/// compute it for the whole line, "csarg" prepared by init_charsize_arg().
+/// The size of a long line is cached.
+static int linesize_line(win_T *wp, linenr_T lnum, CharsizeArg *csarg, CSType cstype)
+{
+  LineSizeEntry *e = linesize_cache_get(wp, lnum, csarg, cstype);
+  if (e != NULL && e->size >= 0) {
+    return e->size;
+  }
+
+  int size = cstype == kCharsizeFast ? linesize_fast(csarg, 0, MAXCOL)
+                                     : linesize_regular(csarg, 0, MAXCOL);
+  if (e != NULL) {
+    e->size = size;
+  }
+  return size;
+}
+
 /// Prepare the structure passed to charsize functions.
 ///
 /// "line" is the start of the line.
@@ -474,11 +605,20 @@ int linesize_fast(CharsizeArg const *const csarg, int vcol_arg, colnr_T const le
 
   char *const line = csarg->line;
   int64_t vcol = vcol_arg;
+  size_t const avail = strnlen(line, (size_t)len + 1);
 
   StrCharInfo ci = utf_ptr2StrCharInfo(line);
   while (ci.ptr - line < len && *ci.ptr != NUL) {
-    vcol += charsize_fast_impl(wp, ci.ptr, use_tabstop, vcol_arg, ci.chr.value).width;
-    ci = utfc_next(ci);
+    size_t run = utf_ascii_run_len(ci.ptr, avail - (size_t)(ci.ptr - line));
+    if (run > 1) {
+      // Printable ASCII takes one cell per character.
+      run = MIN(run, (size_t)(len - (ci.ptr - line)));
+      vcol += (int64_t)run;
+      ci = utf_ptr2StrCharInfo(ci.ptr + run);
+    } else {
+      vcol += charsize_fast_impl(wp, ci.ptr, use_tabstop, vcol_arg, ci.chr.value).width;
+      ci = utfc_next(ci);
+    }
     if (vcol > MAXCOL) {
       vcol_arg = MAXCOL;
       break;
@@ -534,7 +674,43 @@ void getvcol(win_T *wp, pos_T *pos, colnr_T *start, colnr_T *cursor, colnr_T *en
   StrCharInfo ci = utf_ptr2StrCharInfo(line);
   if (cstype == kCharsizeFast) {
     bool const use_tabstop = csarg.use_tabstop;
+    // In a long line start at the last known position before "end_col" and
+    // remember new positions on the way.
+    LineSizeEntry *e = end_col >= LINESIZE_STEP
+                       ? linesize_cache_get(wp, pos->lnum, &csarg, cstype) : NULL;
+    ptrdiff_t next_pos = PTRDIFF_MAX;
+    if (e != NULL) {
+      int i = MIN(end_col / LINESIZE_STEP, (int)kv_size(e->pos)) - 1;
+      while (i >= 0 && kv_A(e->pos, i).col > end_col) {
+        i--;
+      }
+      if (i >= 0) {
+        ci = utf_ptr2StrCharInfo(line + kv_A(e->pos, i).col);
+        vcol = kv_A(e->pos, i).vcol;
+      }
+      next_pos = (ptrdiff_t)(kv_size(e->pos) + 1) * LINESIZE_STEP;
+    }
+    char *const lim = ci.ptr + strnlen(ci.ptr, (size_t)(end_col - (ci.ptr - line)) + 1);
     while (true) {
+      // Printable ASCII before the character at "end_col" takes one cell per
+      // character.
+      ptrdiff_t const off = ci.ptr - line;
+      if (end_col - off > 1) {
+        size_t run = utf_ascii_run_len(ci.ptr, (size_t)(lim - ci.ptr));
+        run = MIN(run, (size_t)(end_col - off));
+        if (next_pos > off) {
+          // Stop at the next position to remember, to keep them LINESIZE_STEP apart.
+          run = MIN(run, (size_t)(next_pos - off));
+        }
+        if (run > 1) {
+          ci = utf_ptr2StrCharInfo(ci.ptr + run);
+          vcol += (colnr_T)run;
+          if (ci.ptr - line >= next_pos) {
+            kv_push(e->pos, ((LineSizePos){ .col = (colnr_T)(ci.ptr - line), .vcol = vcol }));
+            next_pos = (ptrdiff_t)(kv_size(e->pos) + 1) * LINESIZE_STEP;
+          }
+        }
+      }
       if (*ci.ptr == NUL) {
         // if cursor is at NUL, it is treated like 1 cell char
         char_size = (CharSize){ .width = 1 };
@@ -547,6 +723,10 @@ void getvcol(win_T *wp, pos_T *pos, colnr_T *start, colnr_T *cursor, colnr_T *en
       }
       ci = next;
       vcol += char_size.width;
+      if (ci.ptr - line >= next_pos) {
+        kv_push(e->pos, ((LineSizePos){ .col = (colnr_T)(ci.ptr - line), .vcol = vcol }));
+        next_pos = (ptrdiff_t)(kv_size(e->pos) + 1) * LINESIZE_STEP;
+      }
     }
   } else {
     while (true) {
@@ -791,12 +971,7 @@ int plines_win_nofold(win_T *wp, linenr_T lnum)
     return 1;  // be quick for an empty line
   }
 
-  int64_t col;
-  if (cstype == kCharsizeFast) {
-    col = linesize_fast(&csarg, 0, MAXCOL);
-  } else {
-    col = linesize_regular(&csarg, 0, MAXCOL);
-  }
+  int64_t col = linesize_line(wp, lnum, &csarg, cstype);
 
   // If list mode is on, then the '$' at the end of the line may take up one
   // extra column.
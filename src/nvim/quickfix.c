@@ -4067,6 +4067,7 @@ static bool qf_win_pos_update(qf_info_T *qi, int old_qf_index)
       && old_qf_index != qf_index) {
     win->w_redraw_top = MIN(old_qf_index, qf_index);
     win->w_redraw_bot = MAX(old_qf_index, qf_index);
+    win->w_redraw_nranges = -1;
     qf_win_goto(win, qf_index);
   }
   return win != NULL;
@@ -82,6 +82,8 @@ struct regprog {
   unsigned re_engine;  ///< Automatic, backtracking or NFA engine.
   unsigned re_flags;   ///< Second argument for vim_regcomp().
   bool re_in_use;      ///< prog is being executed
+  char *re_key;        ///< key in the regcache[], NULL if it can't be reused
+  bool re_had_eol;     ///< vim_regcomp_had_eol() after compiling it
 };
 
 /// Structure used by the back track matcher.
@@ -94,6 +96,8 @@ typedef struct {
   unsigned re_engine;
   unsigned re_flags;
   bool re_in_use;
+  char *re_key;
+  bool re_had_eol;
 
   int regstart;
   uint8_t reganch;
@@ -115,6 +119,28 @@ struct nfa_state {
   int val;
 };
 
+/// A state of the lazy DFA used by the NFA matcher: a set of NFA states.
+typedef struct {
+  int *ids;             ///< sorted indexes in nfa_regprog_T.state[]
+  int count;            ///< number of items in "ids"
+  unsigned hash;        ///< hash of "ids"
+  bool accept;          ///< contains NFA_MATCH
+  int16_t next[128];    ///< next state for an ASCII byte, -1 if not computed
+} nfa_dstate_T;
+
+/// Lazily built DFA for a NFA program, see nfa_dfa_may_match().
+typedef struct {
+  nfa_dstate_T *states;
+  int count;
+  int size;             ///< allocated items in "states"
+  int start;            ///< index of the start state, -1 if not computed
+  bool reg_ic;          ///< value of rex.reg_ic "states" were computed for
+  int *mark;            ///< for each NFA state: "markid" when added to "work"
+  int markid;
+  int *work;            ///< NFA states of the set being computed
+  int work_count;
+} nfa_dfa_T;
+
 /// Structure used by the NFA matcher.
 typedef struct {
   // These four members implement regprog_T.
@@ -123,12 +149,17 @@ typedef struct {
   unsigned re_engine;
   unsigned re_flags;
   bool re_in_use;
+  char *re_key;
+  bool re_had_eol;
 
   nfa_state_T *start;   ///< points into state[]
 
   int reganch;          ///< pattern starts with ^
   int regstart;         ///< char at start of pattern
   uint8_t *match_text;  ///< plain text to match with
+  uint8_t *regmust;     ///< text that a match must contain, or NULL
+  bool dfa_ok;          ///< all states are supported by nfa_dfa_may_match()
+  nfa_dfa_T *dfa;       ///< allocated when first used
 
   int has_zend;         ///< pattern contains \ze
   int has_backref;      ///< pattern contains \1 .. \9
@@ -8749,6 +8780,150 @@ static uint8_t *nfa_get_match_text(nfa_state_T *start)
   return ret;
 }
 
+enum {
+  NFA_REGMUST_MAX = 64,  ///< maximum length of nfa_regprog_T.regmust
+  NFA_LOOP_MAX = 20,     ///< maximum number of states in a loop for nfa_get_regmust()
+};
+
+// Return true if "state" does not consume text and is always followed by
+// state->out, e.g. zero-width items and group boundaries.
+static bool nfa_is_zero_width(const nfa_state_T *state)
+{
+  switch (state->c) {
+  case NFA_BOL:
+  case NFA_EOL:
+  case NFA_BOF:
+  case NFA_EOF:
+  case NFA_BOW:
+  case NFA_EOW:
+  case NFA_ZSTART:
+  case NFA_ZEND:
+  case NFA_EMPTY:
+  case NFA_CURSOR:
+  case NFA_VISUAL:
+  case NFA_LNUM:
+  case NFA_LNUM_GT:
+  case NFA_LNUM_LT:
+  case NFA_COL:
+  case NFA_COL_GT:
+  case NFA_COL_LT:
+  case NFA_VCOL:
+  case NFA_VCOL_GT:
+  case NFA_VCOL_LT:
+  case NFA_MARK:
+  case NFA_MARK_GT:
+  case NFA_MARK_LT:
+  case NFA_NOPEN:
+  case NFA_NCLOSE:
+    return true;
+  default:
+    return (state->c >= NFA_MOPEN && state->c <= NFA_MCLOSE9)
+           || (state->c >= NFA_ZOPEN && state->c <= NFA_ZCLOSE9);
+  }
+}
+
+// Return the state after "state" if it is always followed by one state and
+// does not match a line break.  Otherwise return NULL.
+static nfa_state_T *nfa_next_single(nfa_state_T *state)
+{
+  if (state->c > 0 || nfa_is_zero_width(state)
+      || (state->c >= NFA_ANY && state->c <= NFA_NUPPER_IC)) {
+    return state->out;
+  }
+  if (state->c == NFA_START_COLL || state->c == NFA_START_NEG_COLL) {
+    // out1 of START points to the END state
+    return state->out1->out;
+  }
+  return NULL;
+}
+
+// Return true if following "body" leads back to "split", which makes the
+// NFA_SPLIT a "*" loop.
+static bool nfa_is_loop(nfa_state_T *body, const nfa_state_T *split)
+{
+  nfa_state_T *p = body;
+  for (int i = 0; p != NULL && i < NFA_LOOP_MAX; i++) {
+    if (p == split) {
+      return true;
+    }
+    p = nfa_next_single(p);
+  }
+  return false;
+}
+
+// Find the longest run of literal text that a match must contain, on the line
+// where the match starts.  Follows the states that every match passes
+// through, skipping "*" loops.  Stops at alternatives, look-around and
+// anything else that may match a line break.
+// Returns the text in allocated memory when it is at least two characters.
+// Otherwise return NULL.
+static uint8_t *nfa_get_regmust(nfa_regprog_T *prog)
+{
+  uint8_t best[NFA_REGMUST_MAX];
+  uint8_t run[NFA_REGMUST_MAX];
+  int best_len = 0;
+  int best_count = 0;
+  int run_len = 0;
+  int run_count = 0;
+  nfa_state_T *p = prog->start;
+
+  for (int steps = 0; p != NULL && steps < prog->nstate; steps++) {
+    if (p->c > 0) {
+      if (run_len + utf_char2len(p->c) <= NFA_REGMUST_MAX) {
+        run_len += utf_char2bytes(p->c, (char *)run + run_len);
+        run_count++;
+        if (run_len > best_len) {
+          memcpy(best, run, (size_t)run_len);
+          best_len = run_len;
+          best_count = run_count;
+        }
+      }
+      p = p->out;
+      continue;
+    }
+    if (nfa_is_zero_width(p)) {
+      p = p->out;
+      continue;
+    }
+
+    // Anything else ends the run of literal text.
+    run_len = 0;
+    run_count = 0;
+    if (p->c == NFA_SPLIT) {
+      if (nfa_is_loop(p->out, p)) {
+        p = p->out1;
+      } else if (nfa_is_loop(p->out1, p)) {
+        p = p->out;
+      } else {
+        break;
+      }
+    } else {
+      p = nfa_next_single(p);
+    }
+  }
+
+  if (best_count < 2) {
+    return NULL;
+  }
+  return (uint8_t *)xmemdupz(best, (size_t)best_len);
+}
+
+// Check whether the text from "s" contains "must", ignoring case.
+static bool nfa_find_regmust_ic(const uint8_t *s, const uint8_t *must)
+{
+  const int c = utf_ptr2char((char *)must);
+  const int len = (int)strlen((char *)must);
+
+  while ((s = (uint8_t *)cstrchr((char *)s, c)) != NULL) {
+    int n = len;
+    if (cstrncmp((char *)s, (char *)must, &n) == 0) {
+      return true;
+    }
+    MB_PTR_ADV(s);
+  }
+  return false;
+}
+
 // Allocate more space for post_start.  Called when
 // running above the estimated number of states.
 static void realloc_post_list(void)
@@ -11628,6 +11803,9 @@ static void nfa_dump(nfa_regprog_T *prog)
   if (prog->match_text != NULL) {
     fprintf(debugf, "match_text: \"%s\"\n", prog->match_text);
   }
+  if (prog->regmust != NULL) {
+    fprintf(debugf, "regmust: \"%s\"\n", prog->regmust);
+  }
 
   fclose(debugf);
 }
@@ -13481,6 +13659,62 @@ static regsubs_T *addstate_here(nfa_list_T *l, nfa_state_T *state, regsubs_T *su
   return r;
 }
 
+// Check character class "cls", one of NFA_WHITE - NFA_NUPPER_IC, against the
+// current character "curc".
+static bool nfa_check_class(int cls, int curc)
+{
+  switch (cls) {
+  case NFA_WHITE:           //  \s
+    return ascii_iswhite(curc);
+  case NFA_NWHITE:          //  \S
+    return curc != NUL && !ascii_iswhite(curc);
+  case NFA_DIGIT:           //  \d
+    return ri_digit(curc);
+  case NFA_NDIGIT:          //  \D
+    return curc != NUL && !ri_digit(curc);
+  case NFA_HEX:             //  \x
+    return ri_hex(curc);
+  case NFA_NHEX:            //  \X
+    return curc != NUL && !ri_hex(curc);
+  case NFA_OCTAL:           //  \o
+    return ri_octal(curc);
+  case NFA_NOCTAL:          //  \O
+    return curc != NUL && !ri_octal(curc);
+  case NFA_WORD:            //  \w
+    return ri_word(curc);
+  case NFA_NWORD:           //  \W
+    return curc != NUL && !ri_word(curc);
+  case NFA_HEAD:            //  \h
+    return ri_head(curc);
+  case NFA_NHEAD:           //  \H
+    return curc != NUL && !ri_head(curc);
+  case NFA_ALPHA:           //  \a
+    return ri_alpha(curc);
+  case NFA_NALPHA:          //  \A
+    return curc != NUL && !ri_alpha(curc);
+  case NFA_LOWER:           //  \l
+    return ri_lower(curc);
+  case NFA_NLOWER:          //  \L
+    return curc != NUL && !ri_lower(curc);
+  case NFA_UPPER:           //  \u
+    return ri_upper(curc);
+  case NFA_NUPPER:          // \U
+    return curc != NUL && !ri_upper(curc);
+  case NFA_LOWER_IC:        // [a-z]
+    return ri_lower(curc) || (rex.reg_ic && ri_upper(curc));
+  case NFA_NLOWER_IC:       // [^a-z]
+    return curc != NUL
+           && !(ri_lower(curc) || (rex.reg_ic && ri_upper(curc)));
+  case NFA_UPPER_IC:        // [A-Z]
+    return ri_upper(curc) || (rex.reg_ic && ri_lower(curc));
+  case NFA_NUPPER_IC:       // [^A-Z]
+    return curc != NUL
+           && !(ri_upper(curc) || (rex.reg_ic && ri_lower(curc)));
+  default:
+    return false;
+  }
+}
+
 // Check character class "class" against current character c.
 static int check_char_class(int cls, int c)
 {
@@ -14918,114 +15152,28 @@ static int nfa_regmatch(nfa_regprog_T *prog, nfa_state_T *start, regsubs_T *subm
         break;
 
       case NFA_WHITE:           //  \s
-        result = ascii_iswhite(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_NWHITE:          //  \S
-        result = curc != NUL && !ascii_iswhite(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_DIGIT:           //  \d
-        result = ri_digit(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_NDIGIT:          //  \D
-        result = curc != NUL && !ri_digit(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_HEX:             //  \x
-        result = ri_hex(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_NHEX:            //  \X
-        result = curc != NUL && !ri_hex(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_OCTAL:           //  \o
-        result = ri_octal(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_NOCTAL:          //  \O
-        result = curc != NUL && !ri_octal(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_WORD:            //  \w
-        result = ri_word(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_NWORD:           //  \W
-        result = curc != NUL && !ri_word(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_HEAD:            //  \h
-        result = ri_head(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_NHEAD:           //  \H
-        result = curc != NUL && !ri_head(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_ALPHA:           //  \a
-        result = ri_alpha(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_NALPHA:          //  \A
-        result = curc != NUL && !ri_alpha(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_LOWER:           //  \l
-        result = ri_lower(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_NLOWER:          //  \L
-        result = curc != NUL && !ri_lower(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_UPPER:           //  \u
-        result = ri_upper(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_NUPPER:          // \U
-        result = curc != NUL && !ri_upper(curc);
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_LOWER_IC:        // [a-z]
-        result = ri_lower(curc) || (rex.reg_ic && ri_upper(curc));
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_NLOWER_IC:       // [^a-z]
-        result = curc != NUL
-                 && !(ri_lower(curc) || (rex.reg_ic && ri_upper(curc)));
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_UPPER_IC:        // [A-Z]
-        result = ri_upper(curc) || (rex.reg_ic && ri_lower(curc));
-        ADD_STATE_IF_MATCH(t->state);
-        break;
-
       case NFA_NUPPER_IC:       // [^A-Z]
-        result = curc != NUL
-                 && !(ri_upper(curc) || (rex.reg_ic && ri_lower(curc)));
+        result = nfa_check_class(t->state->c, curc);
         ADD_STATE_IF_MATCH(t->state);
         break;
 
@@ -15632,6 +15780,254 @@ static int nfa_regtry(nfa_regprog_T *prog, colnr_T col, proftime_T *tm, int *tim
   return 1 + rex.lnum;
 }
 
+enum {
+  NFA_DFA_MAX_STATES = 200,  ///< number of DFA states kept by nfa_dfa_T
+};
+
+// Return true if the lazy DFA can handle all states of "prog": characters,
+// character classes that do not depend on options or the buffer, and
+// collections.  Anything that depends on the position, like "^", "\<" and
+// look-around, or that may match a line break is not supported.
+static bool nfa_dfa_supported(const nfa_regprog_T *prog)
+{
+  for (int i = 0; i < prog->nstate; i++) {
+    const int c = prog->state[i].c;
+    if (c > 0
+        || (c >= NFA_WHITE && c <= NFA_NUPPER_IC)
+        || (c >= NFA_CLASS_ALNUM && c <= NFA_CLASS_ESCAPE && c != NFA_CLASS_PRINT)
+        || (c >= NFA_MOPEN && c <= NFA_MCLOSE9)
+        || (c >= NFA_ZOPEN && c <= NFA_ZCLOSE9)) {
+      continue;
+    }
+    switch (c) {
+    case NFA_SPLIT:
+    case NFA_MATCH:
+    case NFA_EMPTY:
+    case NFA_ANY:
+    case NFA_START_COLL:
+    case NFA_END_COLL:
+    case NFA_START_NEG_COLL:
+    case NFA_END_NEG_COLL:
+    case NFA_RANGE_MIN:
+    case NFA_RANGE_MAX:
+    case NFA_NOPEN:
+    case NFA_NCLOSE:
+    case NFA_ZSTART:
+    case NFA_ZEND:
+      break;
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+static void nfa_dfa_free(nfa_dfa_T *dfa)
+{
+  if (dfa == NULL) {
+    return;
+  }
+  for (int i = 0; i < dfa->count; i++) {
+    xfree(dfa->states[i].ids);
+  }
+  xfree(dfa->states);
+  xfree(dfa->mark);
+  xfree(dfa->work);
+  xfree(dfa);
+}
+
+// Forget all DFA states, e.g. when the cache is full.
+static void nfa_dfa_clear(nfa_dfa_T *dfa)
+{
+  for (int i = 0; i < dfa->count; i++) {
+    xfree(dfa->states[i].ids);
+  }
+  dfa->count = 0;
+  dfa->start = -1;
+}
+
+// Add NFA state "state" to dfa->work, following states that do not consume
+// a character.
+static void nfa_dfa_addstate(nfa_regprog_T *prog, nfa_dfa_T *dfa, nfa_state_T *state)
+{
+  while (state != NULL) {
+    const int id = (int)(state - prog->state);
+    if (dfa->mark[id] == dfa->markid) {
+      return;
+    }
+    dfa->mark[id] = dfa->markid;
+    if (state->c == NFA_SPLIT) {
+      nfa_dfa_addstate(prog, dfa, state->out);
+      state = state->out1;
+    } else if (state->c == NFA_EMPTY || state->c == NFA_NOPEN || state->c == NFA_NCLOSE
+               || state->c == NFA_ZSTART || state->c == NFA_ZEND
+               || (state->c >= NFA_MOPEN && state->c <= NFA_MCLOSE9)
+               || (state->c >= NFA_ZOPEN && state->c <= NFA_ZCLOSE9)) {
+      state = state->out;
+    } else {
+      dfa->work[dfa->work_count++] = id;
+      return;
+    }
+  }
+}
+
+static int nfa_dfa_cmp_id(const void *a, const void *b)
+{
+  return *(const int *)a - *(const int *)b;
+}
+
+// Return true if the character "c" matches the collection starting at
+// NFA_START_COLL or NFA_START_NEG_COLL "state".
+static bool nfa_dfa_coll_match(nfa_state_T *state, int c)
+{
+  const bool result_if_matched = (state->c == NFA_START_COLL);
+  for (state = state->out; state->c != NFA_END_COLL; state = state->out) {
+    if (state->c == NFA_RANGE_MIN) {
+      int c1 = state->val;
+      state = state->out;  // advance to NFA_RANGE_MAX
+      int c2 = state->val;
+      if (c >= c1 && c <= c2) {
+        return result_if_matched;
+      }
+      if (rex.reg_ic) {
+        const int c_low = utf_fold(c);
+        for (; c1 <= c2; c1++) {
+          if (utf_fold(c1) == c_low) {
+            return result_if_matched;
+          }
+        }
+      }
+    } else if (state->c < 0 ? check_char_class(state->c, c)
+                            : (c == state->c
+                               || (rex.reg_ic && utf_fold(c) == utf_fold(state->c)))) {
+      return result_if_matched;
+    }
+  }
+  return !result_if_matched;
+}
+
+// Compute the DFA state after DFA state "from" for the ASCII character "c".
+// Use -1 for "from" to get the start state.  Sets "*cleared" when the cache
+// was full and had to be cleared, "from" is invalid then.
+// Returns the index of the state in dfa->states.
+static int nfa_dfa_step(nfa_regprog_T *prog, nfa_dfa_T *dfa, int from, int c, bool *cleared)
+{
+  if (dfa->markid == INT_MAX) {
+    memset(dfa->mark, 0, (size_t)prog->nstate * sizeof(int));
+    dfa->markid = 0;
+  }
+  dfa->markid++;
+  dfa->work_count = 0;
+  if (from >= 0) {
+    const nfa_dstate_T *ds = &dfa->states[from];
+    for (int i = 0; i < ds->count; i++) {
+      nfa_state_T *state = &prog->state[ds->ids[i]];
+      bool match;
+      if (state->c > 0) {
+        match = c == state->c || (rex.reg_ic && utf_fold(c) == utf_fold(state->c));
+      } else if (state->c == NFA_ANY) {
+        match = true;
+      } else if (state->c == NFA_START_COLL || state->c == NFA_START_NEG_COLL) {
+        match = nfa_dfa_coll_match(state, c);
+        state = state->out1;  // the NFA_END_COLL
+      } else if (state->c == NFA_MATCH) {
+        match = false;
+      } else {
+        match = nfa_check_class(state->c, c);
+      }
+      if (match) {
+        nfa_dfa_addstate(prog, dfa, state->out);
+      }
+    }
+  }
+  // A match may start at any position.
+  nfa_dfa_addstate(prog, dfa, prog->start);
+  qsort(dfa->work, (size_t)dfa->work_count, sizeof(int), nfa_dfa_cmp_id);
+
+  unsigned hash = 0;
+  for (int i = 0; i < dfa->work_count; i++) {
+    hash = hash * 31 + (unsigned)dfa->work[i];
+  }
+  for (int i = 0; i < dfa->count; i++) {
+    nfa_dstate_T *ds = &dfa->states[i];
+    if (ds->hash == hash && ds->count == dfa->work_count
+        && memcmp(ds->ids, dfa->work, (size_t)ds->count * sizeof(int)) == 0) {
+      return i;
+    }
+  }
+
+  if (dfa->count == NFA_DFA_MAX_STATES) {
+    nfa_dfa_clear(dfa);
+    *cleared = true;
+  }
+  if (dfa->count == dfa->size) {
+    // Most patterns need only a few states, grow the table when needed.
+    dfa->size = MIN(MAX(dfa->size * 2, 8), NFA_DFA_MAX_STATES);
+    dfa->states = xrealloc(dfa->states, (size_t)dfa->size * sizeof(nfa_dstate_T));
+  }
+  nfa_dstate_T *ds = &dfa->states[dfa->count];
+  ds->count = dfa->work_count;
+  ds->ids = xmemdup(dfa->work, (size_t)ds->count * sizeof(int));
+  ds->hash = hash;
+  ds->accept = false;
+  for (int i = 0; i < ds->count; i++) {
+    if (prog->state[ds->ids[i]].c == NFA_MATCH) {
+      ds->accept = true;
+    }
+  }
+  memset(ds->next, -1, sizeof(ds->next));
+  return dfa->count++;
+}
+
+// Check with the lazy DFA whether "prog" may match in the text at "s".
+// The DFA only tells whether there is a match, not where, thus a "true"
+// result still needs the NFA.  States are computed when first used and
+// kept for the next call.  Returns true when the text is not ASCII.
+static bool nfa_dfa_may_match(nfa_regprog_T *prog, const uint8_t *s)
+{
+  nfa_dfa_T *dfa = prog->dfa;
+  if (dfa == NULL) {
+    dfa = prog->dfa = xcalloc(1, sizeof(nfa_dfa_T));
+    dfa->mark = xcalloc((size_t)prog->nstate, sizeof(int));
+    dfa->work = xmalloc((size_t)prog->nstate * sizeof(int));
+    dfa->start = -1;
+    dfa->reg_ic = rex.reg_ic;
+  }
+  if (dfa->reg_ic != rex.reg_ic) {
+    nfa_dfa_clear(dfa);
+    dfa->reg_ic = rex.reg_ic;
+  }
+  bool cleared = false;
+  if (dfa->start < 0) {
+    dfa->start = nfa_dfa_step(prog, dfa, -1, NUL, &cleared);
+  }
+
+  int cur = dfa->start;
+  int clear_count = 0;
+  for (; !dfa->states[cur].accept; s++) {
+    if (*s == NUL) {
+      return false;
+    }
+    if (*s >= 0x80) {
+      // Multibyte and composing characters are left to the NFA.
+      return true;
+    }
+    int next = dfa->states[cur].next[*s];
+    if (next < 0) {
+      cleared = false;
+      next = nfa_dfa_step(prog, dfa, cur, *s, &cleared);
+      if (!cleared) {
+        dfa->states[cur].next[*s] = (int16_t)next;
+      } else if (++clear_count > 1) {
+        // The pattern creates too many states, the NFA is faster then.
+        return true;
+      }
+    }
+    cur = next;
+  }
+  return true;
+}
+
 /// Match a regexp against a string ("line" points to the string) or multiple
 /// lines (if "line" is NULL, use reg_getline()).
 ///
@@ -15693,6 +16089,21 @@ static int nfa_regexec_both(uint8_t *line, colnr_T startcol, proftime_T *tm, int
     return 0L;
   }
 
+  // If there is a "must appear" string, look for it.  Lines without it are
+  // rejected with a strstr(), which libc does a word or vector at a time,
+  // instead of running the NFA over every character.
+  if (prog->regmust != NULL && !rex.reg_icombine
+      && (rex.reg_ic
+          ? !nfa_find_regmust_ic(line + col, prog->regmust)
+          : strstr((char *)line + col, (char *)prog->regmust) == NULL)) {
+    return 0L;
+  }
+
+  // For simple patterns check with the DFA if there can be a match at all.
+  if (prog->dfa_ok && !rex.reg_icombine && !nfa_dfa_may_match(prog, line + col)) {
+    return 0L;
+  }
+
   rex.need_clear_subexpr = true;
   // Clear the external match subpointers if necessary.
   if (prog->reghasz == REX_SET) {
@@ -15841,6 +16252,10 @@ static regprog_T *nfa_regcomp(uint8_t *expr, int re_flags)
   prog->reganch = nfa_get_reganch(prog->start, 0);
   prog->regstart = nfa_get_regstart(prog->start, 0);
   prog->match_text = nfa_get_match_text(prog->start);
+  prog->regmust = prog->match_text == NULL ? nfa_get_regmust(prog) : NULL;
+  prog->dfa_ok = !prog->reganch && !prog->has_backref && prog->match_text == NULL
+                 && nfa_dfa_supported(prog);
+  prog->dfa = NULL;
 
 #ifdef REGEXP_DEBUG
   nfa_postfix_dump(expr, OK);
@@ -15876,6 +16291,8 @@ static void nfa_regfree(regprog_T *prog)
   }
 
   xfree(((nfa_regprog_T *)prog)->match_text);
+  xfree(((nfa_regprog_T *)prog)->regmust);
+  nfa_dfa_free(((nfa_regprog_T *)prog)->dfa);
   xfree(((nfa_regprog_T *)prog)->pattern);
   xfree(prog);
 }
@@ -15971,6 +16388,19 @@ static regengine_T nfa_regengine = {
 // Must match with 'regexpengine'.
 static int regexp_engine = 0;
 
+enum {
+  REGCACHE_SIZE = 32,  ///< number of programs kept in regcache[]
+};
+
+/// Compiled programs that were freed, to be reused by vim_regcomp() for the
+/// same pattern.  Autocommand patterns, substitute() in a loop, etc. compile
+/// the same pattern again and again.
+static struct {
+  regprog_T *prog;  ///< NULL for an unused entry
+  uint64_t tick;    ///< regcache_tick when it was added
+} regcache[REGCACHE_SIZE];
+static uint64_t regcache_tick = 0;
+
 #ifdef REGEXP_DEBUG
 static uint8_t regname[][30] = {
   "AUTOMATIC Regexp Engine",
@@ -15988,6 +16418,19 @@ regprog_T *vim_regcomp(const char *expr_arg, int re_flags)
   regprog_T *prog = NULL;
   const char *expr = expr_arg;
 
+  const int called_emsg_start = called_emsg;
+  char *key = regcache_key(expr_arg, re_flags);
+  if (key != NULL) {
+    prog = regcache_take(key);
+    if (prog != NULL) {
+      g_stats.regexp_cache_hit++;
+      had_eol = prog->re_had_eol;
+      xfree(key);
+      return prog;
+    }
+    g_stats.regexp_cache_miss++;
+  }
+
   regexp_engine = (int)p_re;
 
   // Check for prefix "\%#=", that sets the regexp engine
@@ -16058,22 +16501,106 @@ regprog_T *vim_regcomp(const char *expr_arg, int re_flags)
     // to be very slow when executing it.
     prog->re_engine = (unsigned)regexp_engine;
     prog->re_flags = (unsigned)re_flags;
+    prog->re_had_eol = had_eol;
+    // Don't reuse it when an error was given, it would not be given again.
+    prog->re_key = called_emsg == called_emsg_start ? key : NULL;
+  }
+  if (prog == NULL || prog->re_key == NULL) {
+    xfree(key);
   }
 
   return prog;
 }
 
 // Free a compiled regexp program, returned by vim_regcomp().
+// It is kept in the regcache[] when it can be reused.
 void vim_regfree(regprog_T *prog)
 {
-  if (prog != NULL) {
-    prog->engine->regfree(prog);
+  if (prog == NULL) {
+    return;
+  }
+  if (prog->re_key != NULL && !prog->re_in_use) {
+    regcache_put(prog);
+  } else {
+    regprog_free(prog);
+  }
+}
+
+static void regprog_free(regprog_T *prog)
+{
+  xfree(prog->re_key);
+  prog->engine->regfree(prog);
+}
+
+/// Make the key for "expr" and "re_flags" in the regcache[].  Includes all the
+/// state that compiling depends on.
+///
+/// @return  the key in allocated memory, NULL when the pattern must always be
+///          compiled: it depends on the previous substitute string, on
+///          'isprint' or on options of the buffer.
+static char *regcache_key(const char *expr, int re_flags)
+{
+  if (strchr(expr, '~') != NULL
+      || strstr(expr, "[:print:]") != NULL
+      || strstr(expr, "[:keyword:]") != NULL
+      || strstr(expr, "[:ident:]") != NULL
+      || strstr(expr, "[:fname:]") != NULL) {
+    return NULL;
+  }
+  const bool cpo_lit = vim_strchr(p_cpo, CPO_LITERAL) != NULL;
+  size_t len = strlen(expr) + 32;
+  char *key = xmalloc(len);
+  snprintf(key, len, "%d,%d,%d,%x:%s", (int)p_re, cpo_lit, reg_do_extmatch,
+           (unsigned)re_flags, expr);
+  return key;
+}
+
+/// Get a compiled program for "key" from the regcache[].  The caller owns it,
+/// vim_regfree() puts it back.
+///
+/// @return  the program, NULL if there is none.
+static regprog_T *regcache_take(const char *key)
+{
+  for (int i = 0; i < REGCACHE_SIZE; i++) {
+    regprog_T *prog = regcache[i].prog;
+    if (prog != NULL && strcmp(prog->re_key, key) == 0) {
+      regcache[i].prog = NULL;
+      return prog;
+    }
+  }
+  return NULL;
+}
+
+/// Keep "prog" in the regcache[], dropping the least recently used one when
+/// the cache is full.
+static void regcache_put(regprog_T *prog)
+{
+  int idx = 0;
+  for (int i = 0; i < REGCACHE_SIZE; i++) {
+    if (regcache[i].prog == NULL) {
+      idx = i;
+      break;
+    }
+    if (regcache[i].tick < regcache[idx].tick) {
+      idx = i;
+    }
+  }
+  if (regcache[idx].prog != NULL) {
+    regprog_free(regcache[idx].prog);
   }
+  regcache[idx].prog = prog;
+  regcache[idx].tick = ++regcache_tick;
 }
 
 #if defined(EXITFREE)
 void free_regexp_stuff(void)
 {
+  for (int i = 0; i < REGCACHE_SIZE; i++) {
+    if (regcache[i].prog != NULL) {
+      regprog_free(regcache[i].prog);
+      regcache[i].prog = NULL;
+    }
+  }
   ga_clear(&regstack);
   ga_clear(&backpos);
   xfree(reg_tofree);
@@ -83,6 +83,7 @@ struct TUIData {
   SignalWatcher winch_handle;
   uv_timer_t startup_delay_timer;
   UGrid grid;
+  bool grid_synced;  ///< grid cells are known to match the terminal screen
   kvec_t(Rect) invalid_regions;
   int row, col;
   int out_fd;
@@ -141,6 +142,8 @@ struct TUIData {
   int url;  ///< Index of URL currently being printed, if any
   StringBuilder urlbuf;  ///< Re-usable buffer for writing OSC 8 control sequences
   Arena ti_arena;
+  size_t flush_count;  ///< number of writes to the TTY
+  size_t flush_bytes;  ///< bytes written to the TTY
 };
 
 static bool cursor_style_enabled = false;
@@ -604,6 +607,7 @@ static void terminfo_stop(TUIData *tui)
 static void tui_terminal_start(TUIData *tui)
 {
   tui->print_attr_id = -1;
+  tui->grid_synced = false;
   terminfo_start(tui);
   if (tui->input.loop == NULL) {
     tinput_init(&tui->input, &main_loop, &tui->ti);
@@ -648,6 +652,7 @@ void tui_stop(TUIData *tui)
   }
   tui->stopped = true;
 
+  ILOG("TUI: wrote %zu bytes in %zu flushes", tui->flush_bytes, tui->flush_count);
   tui_terminal_stop(tui);
   stream_set_blocking(tui->input.in_fd, true);   // normalize stream (#2598)
   tinput_destroy(&tui->input);
@@ -975,6 +980,32 @@ static bool cheap_to_print(TUIData *tui, int row, int col, int next)
   return true;
 }
 
+/// Move the cursor right to "col" by printing the cells in between again.
+/// This is cheaper than a cursor motion sequence when only a few ASCII cells
+/// with the current attributes are skipped.
+///
+/// @return  false if the cursor was not moved
+static bool reprint_cells(TUIData *tui, int col)
+{
+  UGrid *grid = &tui->grid;
+  int n = col - grid->col;
+  if (n > 3 || col >= tui->width || tui->print_attr_id < 0) {
+    return false;
+  }
+  UCell *cells = grid->cells[grid->row];
+  char buf[3];
+  for (int i = 0; i < n; i++) {
+    UCell *cell = &cells[grid->col + i];
+    buf[i] = (char)schar_get_ascii(cell->data);
+    if (buf[i] == NUL || cell->attr != tui->print_attr_id) {
+      return false;
+    }
+  }
+  out(tui, buf, (size_t)n);
+  grid->col = col;
+  return true;
+}
+
 /// This optimizes several cases where it is cheaper to do something other
 /// than send a full cursor positioning control sequence.  However, there are
 /// some further optimizations that may seem obvious but that will not work.
@@ -1039,6 +1070,9 @@ static void cursor_goto(TUIData *tui, int row, int col)
       ugrid_goto(grid, row, col);
       return;
     } else if (col > grid->col) {
+      if (reprint_cells(tui, col)) {
+        return;
+      }
       int n = col - grid->col;
       if (n <= 2) {
         while (n--) {
@@ -1221,6 +1255,8 @@ void tui_grid_resize(TUIData *tui, Integer g, Integer width, Integer height)
 {
   UGrid *grid = &tui->grid;
   ugrid_resize(grid, (int)width, (int)height);
+  // The terminal may have reflowed its contents.
+  tui->grid_synced = false;
 
   // resize might not always be followed by a clear before flush
   // so clip the invalid region
@@ -1248,6 +1284,7 @@ void tui_grid_clear(TUIData *tui, Integer g)
   schar_cache_clear_if_full();
   kv_size(tui->invalid_regions) = 0;
   clear_region(tui, 0, tui->height, 0, tui->width, 0);
+  tui->grid_synced = true;
 }
 
 void tui_grid_cursor_goto(TUIData *tui, Integer grid, Integer row, Integer col)
@@ -1474,6 +1511,13 @@ void tui_grid_scroll(TUIData *tui, Integer g, Integer startrow, Integer endrow,
     if (!full_screen_scroll) {
       reset_scroll_region(tui, fullwidth);
     }
+
+    // The terminal cleared the rows that were scrolled in.
+    int clear_top = rows > 0 ? bot - (int)rows + 1 : top;
+    int clear_bot = rows > 0 ? bot : top - (int)rows - 1;
+    for (int row = clear_top; row <= clear_bot; row++) {
+      ugrid_clear_chunk(grid, row, left, right + 1, 0);
+    }
   } else {
     // Mark the moved region as invalid for redrawing later
     if (rows > 0) {
@@ -1511,6 +1555,11 @@ void tui_hl_attr_define(TUIData *tui, Integer id, HlAttrs attrs, HlAttrs cterm_a
   attrs.cterm_fg_color = cterm_attrs.cterm_fg_color;
   attrs.cterm_bg_color = cterm_attrs.cterm_bg_color;
 
+  if ((size_t)id < kv_size(tui->attrs)) {
+    // Cells already printed with this id must be printed again.
+    invalidate(tui, 0, tui->grid.height, 0, tui->grid.width);
+    tui->print_attr_id = -1;
+  }
   kv_a(tui->attrs, (size_t)id) = attrs;
 }
 
@@ -1781,15 +1830,27 @@ void tui_raw_line(TUIData *tui, Integer g, Integer linerow, Integer startcol, In
                   const sattr_T *attrs)
 {
   UGrid *grid = &tui->grid;
-  for (Integer c = startcol; c < endcol; c++) {
-    grid->cells[linerow][c].data = chunk[c - startcol];
-    assert((size_t)attrs[c - startcol] < kv_size(tui->attrs));
-    grid->cells[linerow][c].attr = attrs[c - startcol];
-  }
-  UGRID_FOREACH_CELL(grid, (int)linerow, (int)startcol, (int)endcol, {
-    print_cell_at_pos(tui, (int)linerow, curcol, cell,
-                      curcol < endcol - 1 && (cell + 1)->data == NUL);
-  });
+  UCell *cells = grid->cells[linerow];
+  // A wrapped line is printed in full, for the terminal to keep the wrap.
+  bool diff = tui->grid_synced && !(flags & kLineFlagWrap);
+  bool skipped = false;
+  for (int c = (int)startcol; c < endcol; c++) {
+    schar_T data = chunk[c - startcol];
+    sattr_T attr = attrs[c - startcol];
+    assert((size_t)attr < kv_size(tui->attrs));
+    // Don't print a cell the terminal already shows.  The right half of a
+    // double-width char goes with the left half.  A cell after an
+    // ambiguous-width char (grid->row is -1) may have been drawn over.
+    bool same = diff && cells[c].data == data && cells[c].attr == attr
+                && (data == NUL ? skipped : grid->row != -1);
+    cells[c].data = data;
+    cells[c].attr = attr;
+    skipped = same;
+    if (!same) {
+      print_cell_at_pos(tui, (int)linerow, c, &cells[c],
+                        c < endcol - 1 && chunk[c + 1 - startcol] == NUL);
+    }
+  }
 
   if (clearcol > endcol) {
     ugrid_clear_chunk(grid, (int)linerow, (int)endcol, (int)clearcol,
@@ -2525,6 +2586,8 @@ static void flush_buf(TUIData *tui)
       ELOG("uv_write failed: %s", uv_strerror(ret));
     }
     uv_run(&tui->write_loop, UV_RUN_DEFAULT);
+    tui->flush_count++;
+    tui->flush_bytes += bufs[0].len + bufs[1].len + bufs[2].len;
   }
   tui->buf_to_flush = NULL;
   tui->bufpos = 0;
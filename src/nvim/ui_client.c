@@ -41,6 +41,11 @@ static char *tui_term = "";
 static bool tui_rgb = false;
 static bool ui_client_is_remote = false;
 
+/// A "flush" event was the last redraw event, and the TUI was not flushed yet.
+static bool frame_pending = false;
+static size_t frames_flushed = 0;
+static size_t frames_dropped = 0;
+
 // uncrustify:off
 #include "ui_client.c.generated.h"
 #include "ui_events_client.generated.h"
@@ -176,6 +181,7 @@ void ui_client_run(bool remote_ui)
 void ui_client_stop(void)
 {
   ui_client_attached = false;
+  ILOG("UI client: flushed %zu frames, dropped %zu", frames_flushed, frames_dropped);
   if (!tui_is_stopped(tui)) {
     tui_stop(tui);
   }
@@ -275,6 +281,37 @@ void ui_client_event_raw_line(GridLineEvent *g)
                (const schar_T *)grid_line_buf_char, grid_line_buf_attr);
 }
 
+/// Handles the "flush" event. The TUI is flushed when all data read from the
+/// server is handled, so a frame that is followed by a newer one in the same
+/// read is not written to the terminal.
+void ui_client_event_flush(Array args)
+{
+  frame_pending = true;
+}
+
+/// Called after each redraw event is handled.
+///
+/// @param flush  the event was "flush"
+void ui_client_redraw_event_done(bool flush)
+{
+  if (!flush && frame_pending) {
+    // A newer frame has started, it will be flushed instead.
+    frame_pending = false;
+    frames_dropped++;
+  }
+}
+
+/// Flushes the TUI if a frame is complete. Called when the data read from the
+/// server has been handled.
+void ui_client_flush_frame(void)
+{
+  if (frame_pending) {
+    frame_pending = false;
+    frames_flushed++;
+    tui_flush(tui);
+  }
+}
+
 void ui_client_event_connect(Array args)
 {
   if (args.size < 1 || args.items[0].type != kObjectTypeString) {
@@ -55,6 +55,7 @@ typedef struct {
   uint64_t channel_id;
 
 #define UI_BUF_SIZE ARENA_BLOCK_SIZE  ///< total buffer size for pending msgpack data.
+#define UI_WRITE_BATCH 16  ///< max number of filled buffers written together
   /// guaranteed size available for each new event (so packing of simple events
   /// and the header of grid_line will never fail)
 #define EVENT_BUF_SIZE 256
@@ -76,6 +77,11 @@ typedef struct {
 
   size_t ncells_pending;  ///< total number of cells since last buffer flush
 
+  /// Filled buffers not written to the channel yet. They are written together,
+  /// at the end of the redraw or when UI_WRITE_BATCH is reached.
+  struct wbuffer *pending_bufs[UI_WRITE_BATCH];
+  size_t npending_bufs;
+
   int hl_id;  // Current highlight for legacy put event.
   Integer cursor_row, cursor_col;  // Intended visible cursor position.
 
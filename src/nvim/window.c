@@ -5514,6 +5514,7 @@ void win_free(win_T *wp, tabpage_T *tp)
   }
 
   xfree(wp->w_lines);
+  linesize_cache_free(wp);
 
   for (int i = 0; i < wp->w_tagstacklen; i++) {
     tagstack_clear_entry(&wp->w_tagstack[i]);
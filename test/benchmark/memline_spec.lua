@@ -0,0 +1,38 @@
+local n = require('test.functional.testnvim')()
+local exec_lua = n.exec_lua
+
+describe('memline perf', function()
+  before_each(n.clear)
+
+  --- Runs `cmd` on a 1M-line buffer and prints the time taken and the number
+  --- of data block lookups that walked the memline tree.
+  local function measure(name, cmd)
+    local result = exec_lua(function(cmd_)
+      local lines = {}
+      for i = 1, 1000000 do
+        lines[i] = ('line %d foo bar baz'):format(i)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      vim.api.nvim_win_set_cursor(0, { 1, 0 })
+
+      local lookups = vim.api.nvim__stats().ml_find_line
+      local start = vim.uv.hrtime()
+      vim.cmd(cmd_)
+      local elapsed = (vim.uv.hrtime() - start) / 1000000
+      return { elapsed, vim.api.nvim__stats().ml_find_line - lookups }
+    end, cmd)
+    print(('\n%s: %.2f ms, %d tree lookups'):format(name, result[1], result[2]))
+  end
+
+  it(':g', function()
+    measure(':g', [[silent g/9\n.*7$/d]])
+  end)
+
+  it(':s', function()
+    measure(':s', [[silent %s/bar\nline/X/g]])
+  end)
+
+  it('search', function()
+    measure('search', [[call search('99999\n.*100000 ', 'W')]])
+  end)
+end)
@@ -210,6 +210,141 @@ describe('API/extmarks', function()
     eq(false, api.nvim_buf_del_extmark(0, ns, 1000))
   end)
 
+  it('sets many marks with nvim_buf_set_extmarks', function()
+    api.nvim_buf_set_lines(0, 0, -1, true, { 'abc', 'def', 'ghi' })
+    local ids = api.nvim_buf_set_extmarks(0, ns, {
+      { 2, 1, { end_col = 2, hl_group = 'Error' } },
+      { 0, 0 },
+      { 1, 2, {} },
+      { 0, 0, { id = 7 } },
+    })
+    eq(4, #ids)
+    eq(7, ids[4])
+    eq({ 2, 1 }, get_extmark_by_id(ns, ids[1]))
+    eq({ 0, 0 }, get_extmark_by_id(ns, ids[2]))
+    eq({ 1, 2 }, get_extmark_by_id(ns, ids[3]))
+    eq({ 0, 0 }, get_extmark_by_id(ns, 7))
+    local details = get_extmark_by_id(ns, ids[1], { details = true })[3]
+    eq({ 2, 'Error' }, { details.end_col, details.hl_group })
+
+    -- Marks are placed in buffer order, so an id can only be used once.
+    eq(
+      "Duplicate 'id': 9",
+      pcall_err(api.nvim_buf_set_extmarks, 0, ns, { { 2, 0, { id = 9 } }, { 1, 0, { id = 9 } } })
+    )
+    eq({}, get_extmark_by_id(ns, 9))
+
+    eq({}, api.nvim_buf_set_extmarks(0, ns, {}))
+    eq(
+      'Invalid marks item: expected [line, col, opts]',
+      pcall_err(api.nvim_buf_set_extmarks, 0, ns, { { 0 } })
+    )
+    eq(
+      "Invalid 'col': expected Integer, got String",
+      pcall_err(api.nvim_buf_set_extmarks, 0, ns, { { 0, 'x' } })
+    )
+    eq(
+      "Invalid 'opts': expected Dict, got Integer",
+      pcall_err(api.nvim_buf_set_extmarks, 0, ns, { { 0, 0, 1 } })
+    )
+    -- On error the marks created before the failing one are removed, also
+    -- with a new id, but an update of an existing mark by id is kept.
+    local count = #api.nvim_buf_get_extmarks(0, ns, 0, -1, {})
+    eq(
+      "Invalid 'line': out of range",
+      pcall_err(api.nvim_buf_set_extmarks, 0, ns, {
+        { 0, 1 },
+        { 5, 0 },
+        { 1, 1, { id = 7 } },
+        { 1, 0, { id = 5 } },
+      })
+    )
+    eq(count, #api.nvim_buf_get_extmarks(0, ns, 0, -1, {}))
+    eq({ 1, 1 }, get_extmark_by_id(ns, 7))
+    eq({}, get_extmark_by_id(ns, 5))
+    eq("Invalid 'ns_id': 1000", pcall_err(api.nvim_buf_set_extmarks, 0, 1000, {}))
+  end)
+
+  it('replaces marks in a range with nvim_buf_replace_extmarks', function()
+    api.nvim_buf_set_lines(0, 0, -1, true, { 'abc', 'def', 'ghi', 'jkl' })
+    local outside = set_extmark(ns, nil, 3, 0, { hl_group = 'Error', end_col = 1 })
+    local other = set_extmark(ns2, nil, 1, 0, {})
+    local ids = api.nvim_buf_replace_extmarks(0, ns, 0, 3, {
+      { 0, 0, { end_col = 2, hl_group = 'Error' } },
+      { 1, 1, { virt_text = { { 'x', 'Comment' } } } },
+      { 2, 0, { sign_text = 'S' } },
+    })
+
+    -- Unchanged marks keep their ids, others are replaced or removed.
+    local new_ids = api.nvim_buf_replace_extmarks(0, ns, 0, 3, {
+      { 2, 0, { sign_text = 'S' } },
+      { 0, 0, { end_col = 2, hl_group = 'Error' } },
+      { 1, 1, { virt_text = { { 'y', 'Comment' } } } },
+    })
+    eq(ids[3], new_ids[1])
+    eq(ids[1], new_ids[2])
+    ok(new_ids[3] ~= ids[2])
+    eq({}, get_extmark_by_id(ns, ids[2]))
+    eq({ 1, 1 }, get_extmark_by_id(ns, new_ids[3]))
+
+    new_ids = api.nvim_buf_replace_extmarks(0, ns, 0, -1, {
+      { 0, 0, { end_col = 2, hl_group = 'Error', priority = 10 } },
+      { 2, 0, { sign_text = 'S', id = 100 } },
+    })
+    ok(new_ids[1] ~= ids[1])
+    eq(100, new_ids[2])
+    eq({ { new_ids[1], 0, 0 }, { 100, 2, 0 } }, get_extmarks(ns, 0, -1))
+    eq({ { other, 1, 0 } }, get_extmarks(ns2, 0, -1))
+
+    -- Marks outside the range are kept.
+    set_extmark(ns, outside, 3, 0, {})
+    api.nvim_buf_replace_extmarks(0, ns, 0, 3, {})
+    eq({ { outside, 3, 0 } }, get_extmarks(ns, 0, -1))
+
+    -- Nothing is removed on error.
+    set_extmark(ns, 5, 1, 0, {})
+    eq(
+      "Invalid 'line': out of range",
+      pcall_err(api.nvim_buf_replace_extmarks, 0, ns, 0, -1, { { 9, 0 } })
+    )
+    eq({ { 5, 1, 0 }, { outside, 3, 0 } }, get_extmarks(ns, 0, -1))
+
+    -- An empty or reversed range is an error, not a range without marks.
+    eq(
+      "Invalid 'line_end': out of range",
+      pcall_err(api.nvim_buf_replace_extmarks, 0, ns, 1, 1, { { 1, 1 } })
+    )
+    eq(
+      "Invalid 'line_end': out of range",
+      pcall_err(api.nvim_buf_replace_extmarks, 0, ns, 2, 0, { { 1, 1 } })
+    )
+    eq(
+      "Invalid 'line_end': out of range",
+      pcall_err(api.nvim_buf_replace_extmarks, 0, ns, 0, -2, { { 1, 1 } })
+    )
+    -- New marks must be in the range.
+    eq(
+      "Invalid 'line': out of range",
+      pcall_err(api.nvim_buf_replace_extmarks, 0, ns, 1, 2, { { 1, 1 }, { 2, 0 } })
+    )
+    eq(
+      "Invalid 'line': out of range",
+      pcall_err(api.nvim_buf_replace_extmarks, 0, ns, 1, 2, { { 0, 0, { id = 5 } } })
+    )
+    eq({ { 5, 1, 0 }, { outside, 3, 0 } }, get_extmarks(ns, 0, -1))
+
+    -- A mark updated by id is not removed, also among many marks.
+    local many = {}
+    for i = 1, 50 do
+      many[i] = { 1, i % 3 }
+    end
+    api.nvim_buf_replace_extmarks(0, ns, 1, 2, many)
+    eq(51, #get_extmarks(ns, 0, -1))
+    new_ids = api.nvim_buf_replace_extmarks(0, ns, 1, 2, { { 1, 2, { id = 5 } } })
+    eq({ 5 }, new_ids)
+    eq({ { 5, 1, 2 }, { outside, 3, 0 } }, get_extmarks(ns, 0, -1))
+  end)
+
   it('can clear a specific namespace range', function()
     set_extmark(ns, 1, 0, 1)
     set_extmark(ns2, 1, 0, 1)
@@ -226,6 +361,32 @@ describe('API/extmarks', function()
     eq({}, get_extmarks(ns2, { 0, 0 }, { -1, -1 }))
   end)
 
+  it('can clear a small namespace among many marks of other namespaces', function()
+    exec_lua(function(other_ns)
+      local lines = {}
+      for i = 1, 200 do
+        lines[i] = 'line ' .. i
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+      for i = 0, 199 do
+        vim.api.nvim_buf_set_extmark(0, other_ns, i, 0, {})
+        vim.api.nvim_buf_set_extmark(0, other_ns, i, 2, { end_row = i, end_col = 4 })
+      end
+    end, ns2)
+    set_extmark(ns, 1, 10, 0)
+    set_extmark(ns, 2, 5, 0, { end_row = 20, end_col = 0 }) -- only the end is in range
+    set_extmark(ns, 3, 25, 0, { end_row = 30, end_col = 0 })
+    set_extmark(ns, 4, 100, 0)
+    api.nvim_buf_clear_namespace(0, ns, 10, 21)
+    eq({ { 3, 25, 0 }, { 4, 100, 0 } }, get_extmarks(ns, 0, -1))
+    eq(400, #get_extmarks(ns2, 0, -1))
+    -- Ids are not reused while marks remain after the range.
+    eq(5, set_extmark(ns, nil, 0, 0))
+    api.nvim_buf_clear_namespace(0, ns, 0, -1)
+    eq({}, get_extmarks(ns, 0, -1))
+    eq(400, #get_extmarks(ns2, 0, -1))
+  end)
+
   it('can clear a namespace range using 0,-1', function()
     set_extmark(ns, 1, 0, 1)
     set_extmark(ns2, 1, 0, 1)
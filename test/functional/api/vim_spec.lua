@@ -2882,6 +2882,26 @@ describe('API', function()
     end)
   end)
 
+  it('nvim__chan_latency counts requests', function()
+    local function total(hist)
+      local sum = 0
+      for _, count in ipairs(hist) do
+        sum = sum + count
+      end
+      return sum
+    end
+    local before = api.nvim__chan_latency(0)
+    for _ = 1, 10 do
+      api.nvim_get_current_line()
+    end
+    local after = api.nvim__chan_latency(0)
+    -- Also counts the first nvim__chan_latency() call.
+    eq(11, total(after.queued) - total(before.queued))
+    eq(11, total(after.exec) - total(before.exec))
+    eq(21, #after.exec)
+    eq("Invalid 'channel': 2", pcall_err(api.nvim__chan_latency, 2))
+  end)
+
   describe('nvim_call_atomic', function()
     it('works', function()
       api.nvim_buf_set_lines(0, 0, -1, true, { 'first' })
@@ -1450,6 +1450,38 @@ describe('API/win', function()
         api.nvim_win_text_height(0, { max_height = api.nvim_win_get_height(0) })
       )
     end)
+
+    it('with a long line that changes', function()
+      screen:try_resize(45, 10)
+      exec([[call setline(1, repeat('a', 4000) .. "\tb" .. repeat('c', 999))]])
+      local function check(height, vcol, bcol)
+        local expected = { all = height, fill = 0, end_row = 0, end_vcol = vcol }
+        eq(expected, api.nvim_win_text_height(0, {}))
+        eq(vcol - 999, fn.virtcol({ 1, bcol }))
+      end
+      check(112, 5008, 4002)
+      command('set tabstop=16')
+      check(112, 5016, 4002)
+      local id = api.nvim_buf_set_extmark(
+        0,
+        ns,
+        0,
+        10,
+        { virt_text = { { ('!'):rep(50) } }, virt_text_pos = 'inline' }
+      )
+      check(113, 5064, 4002)
+      api.nvim_buf_del_extmark(0, ns, id)
+      check(112, 5016, 4002)
+      command('normal! 0x')
+      check(112, 5000, 4001)
+    end)
+
+    it('with a long line where columns are looked up in any order', function()
+      exec([[call setline(1, "\t" .. repeat('a', 5000))]])
+      for _, col in ipairs({ 4900, 300, 2600, 1, 4000, 257, 4901 }) do
+        eq(col + 7, fn.virtcol({ 1, col }))
+      end
+    end)
   end)
 
   describe('open_win', function()
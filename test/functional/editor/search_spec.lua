@@ -14,3 +14,183 @@ describe('search (/)', function()
     eq([[Vim:E951: \% value too large]], pcall_err(command, '/\\v%2147483648c'))
   end)
 end)
+
+describe('NFA regexp engine', function()
+  before_each(clear)
+
+  it('finds the same matches as the backtracking engine with required text', function()
+    eq(
+      {},
+      n.exec_lua(function()
+        local lines = {
+          'foo_xbar',
+          'foo_bar',
+          'a foo_xyz_bar b',
+          'FOO_XBAR',
+          'foo_x',
+          'xbar',
+          'abcabcabc',
+          'abab',
+          'e\u{301}foo',
+          'a\u{301}b ab',
+          'ÄÖÜ äöü',
+          'helloworld',
+          'hello',
+        }
+        local patterns = {
+          [[\<foo_\w\+bar]],
+          [[foo_\w*bar]],
+          [[\cfoo_\w\+bar]],
+          [[\(abc\)\+]],
+          [[ab\%(ab\)\{-}]],
+          [[x\?bar]],
+          [[[fx]oo_]],
+          [[foo\|abc]],
+          [[ab]],
+          [[\cäöü]],
+          [[hello\zsworld]],
+          [[hello\_.world]],
+          [[hello\nworld]],
+          [[\(foo\)_.*\1]],
+        }
+        local bad = {}
+        for _, pat in ipairs(patterns) do
+          for _, line in ipairs(lines) do
+            local bt = vim.fn.matchstrpos(line, [[\%#=1]] .. pat)
+            local nfa = vim.fn.matchstrpos(line, [[\%#=2]] .. pat)
+            if not vim.deep_equal(bt, nfa) then
+              table.insert(bad, { pat, line, bt, nfa })
+            end
+          end
+        end
+        return bad
+      end)
+    )
+  end)
+
+  it('finds the same matches as the backtracking engine for simple patterns', function()
+    eq(
+      {},
+      n.exec_lua(function()
+        local ab = {}
+        for i = 1, 300 do
+          ab[i] = (i * 7919) % 5 < 2 and 'a' or 'b'
+        end
+        local lines = {
+          'abc123_x',
+          'ABC 12 y',
+          'foo.bar = 0x1F;',
+          '  return x[i];',
+          'tab\there',
+          'ä1_x',
+          table.concat(ab),
+          table.concat(ab):gsub('a', 'c'),
+          '',
+        }
+        local patterns = {
+          [=[[a-c]\+\d\+_]=],
+          [=[\c[a-c]\+ \d]=],
+          [=[[^a-z ]\s]=],
+          [=[[[:alpha:]]\+\.[[:lower:]]\+]=],
+          [[0x\x\+]],
+          [=[\w\+\[\a\+]]=],
+          [[\t\S]],
+          [[\(a\|b\)*a\(a\|b\)\(a\|b\)\(a\|b\)\(a\|b\)\(a\|b\)\(a\|b\)\(a\|b\)b]],
+          [[1\_.x]],
+          [[x*]],
+        }
+        local bad = {}
+        for _, ic in ipairs({ false, true }) do
+          vim.o.ignorecase = ic
+          for _, pat in ipairs(patterns) do
+            for _, line in ipairs(lines) do
+              -- Twice: the second time uses the states computed the first time.
+              for _ = 1, 2 do
+                local bt = vim.fn.matchstrpos(line, [[\%#=1]] .. pat)
+                local nfa = vim.fn.matchstrpos(line, [[\%#=2]] .. pat)
+                if not vim.deep_equal(bt, nfa) then
+                  table.insert(bad, { ic, pat, line, bt, nfa })
+                end
+              end
+            end
+          end
+        end
+        return bad
+      end)
+    )
+  end)
+end)
+
+describe('compiled pattern cache', function()
+  before_each(clear)
+
+  it('reuses patterns compiled with the same flags', function()
+    local res = n.exec_lua(function()
+      local before = vim.api.nvim__stats()
+      local out = {}
+      for i = 1, 10 do
+        out[i] = vim.fn.substitute('foo' .. i, [[o\+\(\d\)]], [[-\1]], '')
+      end
+      local after = vim.api.nvim__stats()
+      return {
+        out[1],
+        out[10],
+        after.regexp_cache_hit - before.regexp_cache_hit >= 9,
+      }
+    end)
+    eq({ 'f-1', 'f-10', true }, res)
+  end)
+
+  it('compiles again when an option used by the compiler changed', function()
+    eq(
+      { -1, 1 },
+      n.exec_lua(function()
+        local r = {}
+        r[1] = vim.fn.match('at', [=[[\t]]=])
+        vim.o.cpoptions = vim.o.cpoptions .. 'l'
+        r[2] = vim.fn.match('at', [=[[\t]]=])
+        return r
+      end)
+    )
+  end)
+
+  it("compiles [:print:] again when 'isprint' changed", function()
+    eq(
+      { 0, -1 },
+      n.exec_lua(function()
+        local r = {}
+        -- The backtracking engine expands the class when compiling.
+        r[1] = vim.fn.match(vim.fn.nr2char(161), [=[\%#=1^[[:print:]]$]=])
+        vim.o.isprint = '@'
+        r[2] = vim.fn.match(vim.fn.nr2char(161), [=[\%#=1^[[:print:]]$]=])
+        return r
+      end)
+    )
+  end)
+
+  it('keeps whether a syntax pattern matches the end-of-line', function()
+    eq(
+      { 'Line', 'Line', '', '' },
+      n.exec_lua(function()
+        vim.api.nvim_buf_set_lines(0, 0, -1, true, { '# a \\', 'b' })
+        --- Returns the syntax group of line 2, which is only in the region when
+        --- "cont" matches the end-of-line.
+        local function define(cont, other)
+          vim.cmd('syntax clear')
+          vim.cmd('syntax region Line start=/^#/ end=/$/ contains=Cont')
+          vim.cmd('syntax match Cont /' .. cont .. '/ contained')
+          -- Compile a new pattern, so that the next define() only has cache
+          -- hits after a pattern that does the opposite with "$".
+          vim.fn.matchstr('', other)
+          return vim.fn.synIDattr(vim.fn.synID(2, 1, 1), 'name')
+        end
+        return {
+          define([[\\$]], 'other1'),
+          define([[\\$]], 'other2'),
+          define([[\\]], 'other3$'),
+          define([[\\]], 'other4$'),
+        }
+      end)
+    )
+  end)
+end)
@@ -116,6 +116,23 @@ describe('thread', function()
         { 1, 2 }                                          |
       ]])
     end)
+
+    it('wakes up the main loop once per batch', function()
+      local before = exec_lua('return vim.api.nvim__stats()')
+      exec_lua [[
+        local thread = vim.uv.new_thread(function()
+          for i = 1, 100 do
+            print('print ' .. i)
+          end
+        end)
+        vim.uv.thread_join(thread)
+      ]]
+
+      screen:expect({ any = 'print 100' })
+      local after = exec_lua('return vim.api.nvim__stats()')
+      eq(1, after.thread_wakeups - before.thread_wakeups)
+      eq(true, after.thread_events_max >= 100)
+    end)
   end)
 
   describe('vim.*', function()
@@ -774,6 +774,47 @@ describe('TUI', function()
     ]])
   end)
 
+  it('redraws changed cells between unchanged cells', function()
+    child_session:request('nvim_buf_set_lines', 0, 0, -1, true, {
+      'abcdefghij',
+      'line 2',
+      'line 3',
+      'line 4',
+      'line 5',
+    })
+    screen:expect([[
+      ^abcdefghij                                        |
+      line 2                                            |
+      line 3                                            |
+      line 4                                            |
+      {3:[No Name] [+]                                     }|
+                                                        |
+      {5:-- TERMINAL --}                                    |
+    ]])
+    child_session:request('nvim_buf_set_text', 0, 0, 2, 0, 3, { 'X' })
+    child_session:request('nvim_buf_set_text', 0, 0, 7, 0, 8, { 'Y' })
+    screen:expect([[
+      ^abXdefgYij                                        |
+      line 2                                            |
+      line 3                                            |
+      line 4                                            |
+      {3:[No Name] [+]                                     }|
+                                                        |
+      {5:-- TERMINAL --}                                    |
+    ]])
+    -- Rows scrolled in are cleared by the terminal.
+    feed_data('\005')
+    screen:expect([[
+      ^line 2                                            |
+      line 3                                            |
+      line 4                                            |
+      line 5                                            |
+      {3:[No Name] [+]                                     }|
+                                                        |
+      {5:-- TERMINAL --}                                    |
+    ]])
+  end)
+
   it('interprets leading <Esc> byte as ALT modifier in normal-mode', function()
     local keys = 'dfghjkl'
     for c in keys:gmatch('.') do
@@ -4337,6 +4378,80 @@ describe('TUI client', function()
     assert_log('Failed to chdir to README.md: not a directory', testlog)
   end)
 
+  it('draws redraw events when a frame is flushed', function()
+    local server, _, screen_client = start_headless_server_and_client(false)
+    local server_exec_lua = tt.make_lua_executor(server)
+    --- Sends redraw events to the client directly, not through the server UI.
+    local function send(...)
+      server_exec_lua([[vim.rpcnotify(vim.api.nvim_list_uis()[1].chan, 'redraw', ...)]], ...)
+    end
+
+    -- A frame without "flush" is not written to the terminal yet.
+    send({ 'grid_line', { 1, 1, 0, { { 'X', 0, 7 } }, false } })
+    screen_client:expect_unchanged()
+
+    -- It is when the "flush" arrives later.
+    send({ 'flush', {} })
+    screen_client:expect({ any = 'XXXXXXX' })
+
+    -- A frame that ends in "flush" is drawn.
+    send({ 'grid_line', { 1, 2, 0, { { 'Y', 0, 7 } }, false } }, { 'flush', {} })
+    screen_client:expect({ any = 'YYYYYYY' })
+  end)
+
+  it('does not write a frame that is followed by a newer one in the same read', function()
+    t.skip(is_os('win'), 'ConPTY rewrites the output')
+    local server = n.new_session(false)
+    local client_super = n.new_session(true)
+    finally(function()
+      client_super:close()
+      server:close()
+    end)
+    set_session(server)
+    local server_pipe = api.nvim_get_vvar('servername')
+
+    -- Collect everything the client writes to its terminal.
+    set_session(client_super)
+    exec_lua(function(argv)
+      _G.output = ''
+      vim.fn.jobstart(argv, {
+        pty = true,
+        width = 50,
+        height = 7,
+        env = { TERM = 'xterm-256color' },
+        on_stdout = function(_, data)
+          _G.output = _G.output .. table.concat(data, '\n')
+        end,
+      })
+    end, { nvim_prog, '--remote-ui', '--server', server_pipe })
+
+    set_session(server)
+    retry(nil, nil, function()
+      eq(1, #api.nvim_list_uis())
+    end)
+    -- Three frames in one message: only the last one is written.
+    exec_lua(function()
+      vim.rpcnotify(
+        vim.api.nvim_list_uis()[1].chan,
+        'redraw',
+        { 'grid_line', { 1, 2, 0, { { 'X', 0, 7 } }, false } },
+        { 'flush', {} },
+        { 'grid_line', { 1, 2, 0, { { 'W', 0, 7 } }, false } },
+        { 'flush', {} },
+        { 'grid_line', { 1, 2, 0, { { 'Y', 0, 7 } }, false } },
+        { 'flush', {} }
+      )
+    end)
+
+    set_session(client_super)
+    retry(nil, nil, function()
+      ok(exec_lua('return _G.output'):find('YYYYYYY', 1, true) ~= nil)
+    end)
+    local output = exec_lua('return _G.output')
+    eq(nil, output:find('XXXXXXX', 1, true))
+    eq(nil, output:find('WWWWWWW', 1, true))
+  end)
+
   it('nvim_ui_send works with remote client #36317', function()
     local server, _, _ = start_headless_server_and_client(false)
     server:request('nvim_ui_send', '\027]2;TEST_TITLE\027\\')
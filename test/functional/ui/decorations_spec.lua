@@ -184,6 +184,99 @@ describe('decorations providers', function()
     }
   end)
 
+  it('can cache highlights until the buffer changes', function()
+    insert(mulholland)
+    exec_lua(function()
+      local hl = vim.api.nvim_get_hl_id_by_name('ErrorMsg')
+      local ns = vim.api.nvim_create_namespace('cached')
+      _G.calls = 0
+      vim.api.nvim_set_decoration_provider(ns, {
+        cache = true,
+        on_range = function(_, _, buf, row)
+          _G.calls = _G.calls + 1
+          vim.api.nvim_buf_set_extmark(buf, ns, row, row, {
+            end_row = row,
+            end_col = row + 1,
+            hl_group = hl,
+            ephemeral = true,
+          })
+        end,
+      })
+    end)
+    local grid = [[
+      {2:/}/ just to see if there was an accident |
+      /{2:/} on Mulholland Drive                  |
+      tr{2:y}_start();                            |
+      buf{2:r}ef_T save_buf;                      |
+      swit{2:c}h_buffer(&save_buf, buf);          |
+      posp {2:=} getmark(mark, false);            |
+      restor{2:e}_buffer(&save_buf);^              |
+                                              |
+    ]]
+    screen:expect(grid)
+    eq(7, exec_lua('return _G.calls'))
+
+    -- Redrawing an unchanged buffer reuses the highlights.
+    command('redraw!')
+    screen:expect_unchanged()
+    eq(7, exec_lua('return _G.calls'))
+
+    feed('ggx')
+    screen:expect([[
+      {2:^/} just to see if there was an accident  |
+      /{2:/} on Mulholland Drive                  |
+      tr{2:y}_start();                            |
+      buf{2:r}ef_T save_buf;                      |
+      swit{2:c}h_buffer(&save_buf, buf);          |
+      posp {2:=} getmark(mark, false);            |
+      restor{2:e}_buffer(&save_buf);              |
+                                              |
+    ]])
+    eq(true, exec_lua('return _G.calls') > 7)
+  end)
+
+  it('does not cache rows where on_range returned a skip position', function()
+    insert(mulholland)
+    exec_lua(function()
+      local hl = vim.api.nvim_get_hl_id_by_name('ErrorMsg')
+      local ns = vim.api.nvim_create_namespace('cached')
+      _G.calls = 0
+      vim.api.nvim_set_decoration_provider(ns, {
+        cache = true,
+        on_range = function(_, _, buf, row)
+          _G.calls = _G.calls + 1
+          local last = math.min(row + 2, vim.api.nvim_buf_line_count(buf) - 1)
+          for r = row, last do
+            vim.api.nvim_buf_set_extmark(buf, ns, r, 0, {
+              end_row = r,
+              end_col = 1,
+              hl_group = hl,
+              ephemeral = true,
+            })
+          end
+          return row + 3, 0
+        end,
+      })
+    end)
+    local grid = [[
+      {2:/}/ just to see if there was an accident |
+      {2:/}/ on Mulholland Drive                  |
+      {2:t}ry_start();                            |
+      {2:b}ufref_T save_buf;                      |
+      {2:s}witch_buffer(&save_buf, buf);          |
+      {2:p}osp = getmark(mark, false);            |
+      {2:r}estore_buffer(&save_buf);^              |
+                                              |
+    ]]
+    screen:expect(grid)
+    eq(3, exec_lua('return _G.calls'))
+
+    -- The skip positions still apply when redrawing an unchanged buffer.
+    command('redraw!')
+    screen:expect_unchanged()
+    eq(6, exec_lua('return _G.calls'))
+  end)
+
   it('can indicate spellchecked points', function()
     exec [[
     set spell
@@ -1175,6 +1268,48 @@ describe('extmark decorations', function()
     ns = api.nvim_create_namespace 'test'
   end)
 
+  it('only redraws the lines of changed marks', function()
+    exec_lua(function()
+      local lines = {}
+      for i = 1, 30 do
+        lines[i] = 'line ' .. i
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    end)
+    screen:expect({ any = 'line 14' })
+
+    local stats = exec_lua(function(ns_)
+      local before = vim.api.nvim__stats()
+      vim.api.nvim_buf_set_extmark(0, ns_, 1, 0, { end_col = 4, hl_group = 'ErrorMsg' })
+      vim.api.nvim_buf_set_extmark(0, ns_, 12, 0, { end_col = 4, hl_group = 'ErrorMsg' })
+      vim.cmd('redraw')
+      local after = vim.api.nvim__stats()
+      return {
+        after.redraw_lines - before.redraw_lines,
+        after.redraw_lines_skipped - before.redraw_lines_skipped,
+      }
+    end, ns)
+    -- Lines 3 to 12 in between the marks are not drawn again.
+    eq({ 2, 12 }, stats)
+    screen:expect([[
+      ^line 1                                            |
+      {4:line} 2                                            |
+      line 3                                            |
+      line 4                                            |
+      line 5                                            |
+      line 6                                            |
+      line 7                                            |
+      line 8                                            |
+      line 9                                            |
+      line 10                                           |
+      line 11                                           |
+      line 12                                           |
+      {4:line} 13                                           |
+      line 14                                           |
+                                                        |
+    ]])
+  end)
+
   it('empty virtual text at eol should not break colorcolumn #17860', function()
     insert(example_text)
     feed('gg')
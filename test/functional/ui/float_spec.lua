@@ -451,6 +451,65 @@ describe('float window', function()
     eq(2, line)
   end)
 
+  it('hidden float is not drawn until it is shown', function()
+    local screen = Screen.new(30, 8)
+    local buf = api.nvim_create_buf(false, true)
+    local win = api.nvim_open_win(buf, false, {
+      relative = 'editor',
+      row = 1,
+      col = 1,
+      width = 20,
+      height = 4,
+      hide = true,
+    })
+    command('redraw')
+    local drawn = exec_lua(function(b)
+      local lines = vim.api.nvim__stats().redraw_lines
+      for i = 1, 5 do
+        vim.api.nvim_buf_set_lines(b, 0, -1, true, { 'float ' .. i, 'text ' .. i })
+        vim.cmd('redraw')
+      end
+      return vim.api.nvim__stats().redraw_lines - lines
+    end, buf)
+    eq(0, drawn)
+
+    api.nvim_win_set_config(win, { hide = false })
+    screen:expect({ any = 'float 5' })
+    screen:expect({ any = 'text 5' })
+  end)
+
+  it('hidden float shows buffer changes made while hidden', function()
+    local screen = Screen.new(30, 8)
+    local buf = api.nvim_create_buf(false, true)
+    api.nvim_buf_set_lines(buf, 0, -1, true, { 'old 1', 'old 2' })
+    local win = api.nvim_open_win(buf, false, {
+      relative = 'editor',
+      row = 1,
+      col = 1,
+      width = 20,
+      height = 2,
+    })
+    screen:expect([[
+      ^                              |
+      {1:~}{4:old 1               }{1:         }|
+      {1:~}{4:old 2               }{1:         }|
+      {1:~                             }|*4
+                                    |
+    ]])
+
+    api.nvim_win_set_config(win, { hide = true })
+    api.nvim_buf_set_lines(buf, 0, -1, true, { 'new 1', 'new 2' })
+    command('redraw')
+    api.nvim_win_set_config(win, { hide = false })
+    screen:expect([[
+      ^                              |
+      {1:~}{4:new 1               }{1:         }|
+      {1:~}{4:new 2               }{1:         }|
+      {1:~                             }|*4
+                                    |
+    ]])
+  end)
+
   it(':unhide works when there are floating windows', function()
     local float_opts = { relative = 'editor', row = 1, col = 1, width = 5, height = 5 }
     local w0 = curwin()
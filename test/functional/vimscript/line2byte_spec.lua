@@ -0,0 +1,69 @@
+local t = require('test.testutil')
+local n = require('test.functional.testnvim')()
+
+local clear = n.clear
+local eq = t.eq
+local exec_lua = n.exec_lua
+
+describe('line2byte() and byte2line()', function()
+  before_each(clear)
+
+  -- Compares line2byte()/byte2line() against offsets computed from the lines, for every line.
+  local function check(ff)
+    eq(
+      {},
+      exec_lua(function(fileformat)
+        vim.bo.fileformat = fileformat
+        local eol = fileformat == 'dos' and 2 or 1
+        local bad = {}
+        local off = 1
+        local lines = vim.api.nvim_buf_get_lines(0, 0, -1, true)
+        for lnum, line in ipairs(lines) do
+          if vim.fn.line2byte(lnum) ~= off then
+            table.insert(bad, { 'line2byte', lnum, vim.fn.line2byte(lnum), off })
+          end
+          if vim.fn.byte2line(off) ~= lnum then
+            table.insert(bad, { 'byte2line', off, vim.fn.byte2line(off), lnum })
+          end
+          off = off + #line + eol
+          if #bad > 10 then
+            break
+          end
+        end
+        return bad
+      end, ff)
+    )
+  end
+
+  it('stay correct while a large buffer is edited', function()
+    exec_lua(function()
+      local lines = {}
+      for i = 1, 20000 do
+        lines[i] = string.rep('x', i % 37)
+      end
+      vim.api.nvim_buf_set_lines(0, 0, -1, true, lines)
+    end)
+    check('unix')
+    check('dos')
+
+    exec_lua(function()
+      -- Insert and delete lines in the middle, splitting and merging chunks.
+      for i = 1, 3000 do
+        vim.api.nvim_buf_set_lines(0, 5000 + i, 5000 + i, true, { 'inserted ' .. i })
+      end
+      vim.api.nvim_buf_set_lines(0, 100, 2100, true, {})
+      local block = {}
+      for i = 1, 1000 do
+        block[i] = 'yy'
+      end
+      vim.api.nvim_buf_set_lines(0, 15000, 15000, true, block)
+      -- Change lines in place.
+      for i = 1, 500 do
+        vim.api.nvim_buf_set_lines(0, i * 30, i * 30 + 1, true, { string.rep('z', i) })
+      end
+    end)
+    check('unix')
+    check('mac')
+    check('dos')
+  end)
+end)
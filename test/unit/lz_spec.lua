@@ -0,0 +1,68 @@
+local t = require('test.unit.testutil')
+local itp = t.gen_itp(it)
+
+local cimport = t.cimport
+local eq = t.eq
+local ffi = t.ffi
+
+local lz = cimport('./src/nvim/lz.h')
+
+--- Compresses `s` into a buffer of `dst_size` bytes.
+--- @return string? compressed data, nil if it did not fit
+local function compress(s, dst_size)
+  local dst = ffi.new('char[?]', dst_size + 1)
+  local len = tonumber(lz.lz_compress(s, #s, dst, dst_size))
+  if len == 0 then
+    return nil
+  end
+  return ffi.string(dst, len)
+end
+
+--- @return string? decompressed data, nil if it is corrupted
+local function decompress(c, size)
+  local dst = ffi.new('char[?]', size + 1)
+  if not lz.lz_decompress(c, #c, dst, size) then
+    return nil
+  end
+  return ffi.string(dst, size)
+end
+
+describe('lz_compress() and lz_decompress()', function()
+  itp('round-trip', function()
+    local inputs = {
+      '',
+      'a',
+      'abcdefgh',
+      ('x'):rep(10000),
+      ('int main(void)\n{\n  return 0;\n}\n'):rep(100),
+    }
+    local seq = {}
+    for i = 1, 3000 do
+      seq[i] = string.char((i * 7919) % 251)
+    end
+    inputs[#inputs + 1] = table.concat(seq)
+    for _, s in ipairs(inputs) do
+      local c = compress(s, #s + 64)
+      eq(s, decompress(c, #s))
+    end
+  end)
+
+  itp('makes repetitive data smaller', function()
+    local s = ('line of text\n'):rep(300)
+    local c = compress(s, #s)
+    assert(#c < #s / 4)
+  end)
+
+  itp('gives up when the output does not fit', function()
+    local s = ('abcd'):rep(100)
+    eq(nil, compress(s, 4))
+  end)
+
+  itp('rejects a wrong size and corrupted data', function()
+    local s = ('some words, some words\n'):rep(50)
+    local c = compress(s, #s)
+    eq(nil, decompress(c, #s - 1))
+    eq(nil, decompress(c, #s + 1))
+    eq(nil, decompress(c:sub(1, #c - 3), #s))
+  end)
+end)
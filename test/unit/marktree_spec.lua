@@ -669,4 +669,36 @@ describe('marktree', function()
     lib.marktree_splice(tree, 48, 0, 139, 0, 0, 0)
     ok(lib.marktree_check_intersections(tree))
   end)
+
+  itp('counts marks per namespace', function()
+    local tree = ffi.new('MarkTree[1]') -- zero initialized by luajit
+    local iter = ffi.new('MarkTreeIter[1]')
+    local ids = {}
+    for i = 1, 100 do
+      ids[i] = put(tree, i, 0, false, i + 1, 0, false)
+      lib.marktree_put_test(tree, ns + 1, i, i, 2, false, -1, -1, false, false)
+    end
+    eq(100, tonumber(lib.marktree_ns_count(tree, ns)))
+    eq(100, tonumber(lib.marktree_ns_count(tree, ns + 1)))
+    eq(0, tonumber(lib.marktree_ns_count(tree, ns + 2)))
+
+    for i = 1, 100, 2 do
+      lib.marktree_del_pair_test(tree, ns, ids[i])
+    end
+    eq(50, tonumber(lib.marktree_ns_count(tree, ns)))
+
+    -- moving a mark does not change the count
+    lib.marktree_lookup_ns(tree, ns, ids[2], false, iter)
+    lib.marktree_move(tree, iter, 200, 0)
+    eq(50, tonumber(lib.marktree_ns_count(tree, ns)))
+
+    for i = 2, 100, 2 do
+      lib.marktree_del_pair_test(tree, ns, ids[i])
+    end
+    eq(0, tonumber(lib.marktree_ns_count(tree, ns)))
+    eq(true, lib.marktree_ns_ids(tree, ns) == nil)
+    eq(100, tonumber(lib.marktree_ns_count(tree, ns + 1)))
+    lib.marktree_clear(tree)
+    eq(0, tonumber(lib.marktree_ns_count(tree, ns + 1)))
+  end)
 end)
@@ -348,6 +348,24 @@ describe('mbyte', function()
     -- stylua: ignore end
   end)
 
+  itp('utf_ascii_run_len', function()
+    local function run_len(str, len)
+      return tonumber(lib.utf_ascii_run_len(to_cstr(str), len or #str))
+    end
+    eq(0, run_len(''))
+    eq(5, run_len('hello'))
+    eq(3, run_len('foo\tbar'))
+    eq(3, run_len('foo\127'))
+    eq(40, run_len(('0123456789'):rep(4) .. '\n'))
+    eq(37, run_len(('x'):rep(37) .. '\000' .. ('x'):rep(20)))
+    -- Stops before a character that may take a composing character.
+    eq(4, run_len('abcde\204\129'))
+    eq(19, run_len(('a'):rep(20) .. 'å'))
+    -- Does not look past "len".
+    eq(10, run_len(('y'):rep(40), 10))
+    eq(4, run_len('abcd\204\129', 4))
+  end)
+
   describe('utf_fold', function()
     itp('does not crash with surrogates #30527', function()
       eq(0xddfb, lib.utf_fold(0xddfb)) -- low surrogate, invalid as a character
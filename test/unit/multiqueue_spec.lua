@@ -146,4 +146,27 @@ describe('multiqueue (multi-level event-queue)', function()
     eq('c3i1', get(child3))
     eq('c3i2', get(child3))
   end)
+
+  itp('takes every few events from a background child', function()
+    local bg = multiqueue.multiqueue_new_child(parent)
+    multiqueue.multiqueue_set_background(bg)
+    put(bg, 'b1')
+    put(bg, 'b2')
+    put(child1, 'c1i4')
+    eq('c1i1', get(parent))
+    eq('c1i2', get(parent))
+    eq('c2i1', get(parent))
+    eq('b1', get(parent))
+    eq('c1i3', get(parent))
+    eq('c1i4', get(child1))
+    eq('c2i2', get(parent))
+    eq('c2i3', get(parent))
+    eq('b2', get(parent))
+    put(bg, 'b3')
+    eq('b3', get(bg))
+    eq('c2i4', get(parent))
+    eq('c3i1', get(parent))
+    eq('c3i2', get(parent))
+    eq(true, multiqueue.multiqueue_empty(parent))
+  end)
 end)